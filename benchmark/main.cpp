@@ -0,0 +1,685 @@
+
+// MIT License
+//
+// Copyright (c) 2019 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Headless benchmarks of the cpu paths of sfml-extensions, no window (or
+// display) is needed. Prints one csv record per benchmark and input size:
+//
+//     benchmark,size,iterations,ns_per_op,bytes_per_s,allocations_per_op,max_error
+//
+// One op is one call on an input of size items (particles, timers, control
+// points, segment pairs or bytes), bytes_per_s is the data that call reads
+// and/or writes, per second, allocations_per_op counts the operator new calls.
+// max_error is the largest absolute error of an approximation against the
+// exact result, 0 for the exact benchmarks. An argument selects the benchmarks whose name
+// contains it, f.e. 'benchmark lz4'.
+//
+// Windows: benchmark.vcxproj. Linux, from this directory:
+//
+//     g++ -std=c++2a -O3 -DNDEBUG -DNOMINMAX -DLZ4F_STATIC_LINKING_ONLY -I../sfml-extensions
+//         main.cpp ../sfml-extensions/{Animation,CatmullRom,EasingTable,Extensions,LZ4Stream,ParticelSystem,
+//         ParticleKernels,ThreadPool,z85_impl}.cpp -x c++ ../sfml-extensions/z85.c
+//         -lsfml-graphics -lsfml-window -lsfml-system -llz4 -lpthread -o benchmark
+//
+// with a static liblz4, the shared one doesn't export the dictionary functions.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "Extensions/Extensions.hpp"
+#include "Extensions/Animation.hpp"
+#include "Extensions/BatchAnimator.hpp"
+#include "Extensions/CatmullRom.hpp"
+#include "Extensions/EasingTable.hpp"
+#include "Extensions/LZ4Stream.hpp"
+#include "Extensions/Nanotimer.hpp"
+#include "Extensions/ParticleSystem.hpp"
+#include "Extensions/ThreadPool.hpp"
+#include "Extensions/Timeline.hpp"
+#include "Extensions/Tween.hpp"
+#include "Extensions/Z85.hpp"
+
+
+std::atomic<std::size_t> g_allocations { 0u };
+
+void * operator new ( std::size_t size_ ) {
+    g_allocations.fetch_add ( 1u, std::memory_order_relaxed );
+    if ( void * p = std::malloc ( size_ ? size_ : 1u ) ) {
+        return p;
+    }
+    throw std::bad_alloc ( );
+}
+
+void operator delete ( void * p_ ) noexcept {
+    std::free ( p_ );
+}
+
+void operator delete ( void * p_, std::size_t ) noexcept {
+    std::free ( p_ );
+}
+
+
+namespace {
+
+const char * g_filter = nullptr;
+
+// Keeps the results alive, so the optimizer can't drop the work.
+volatile float g_sink_float = 0.0f;
+volatile std::size_t g_sink_size = 0u;
+
+// Calls op_ in batches, doubling the batch until it takes at least 0.25 s,
+// and reports the last batch. Returns the ns per op, 0 if filtered out.
+template<typename Op>
+double run ( const char * name_, const std::size_t size_, const double bytes_per_op_, Op && op_, const double max_error_ = 0.0 ) {
+    if ( g_filter and not std::strstr ( name_, g_filter ) ) {
+        return 0.0;
+    }
+    op_ ( ); // Warm up.
+    std::uint64_t iterations = 1u;
+    double ns = 0.0;
+    std::size_t allocations = 0u;
+    for ( ;; iterations *= 2u ) {
+        const std::size_t allocations_start = g_allocations.load ( std::memory_order_relaxed );
+        sf::NanoTimer timer;
+        timer.start ( );
+        for ( std::uint64_t i = 0u; i < iterations; ++i ) {
+            op_ ( );
+        }
+        ns = timer.getElapsedNs ( );
+        allocations = g_allocations.load ( std::memory_order_relaxed ) - allocations_start;
+        if ( ns >= 250'000'000.0 or iterations >= ( 1u << 30 ) ) {
+            break;
+        }
+    }
+    const double ns_per_op = ns / ( double ) iterations;
+    std::printf ( "%s,%zu,%llu,%.3f,%.0f,%.3f,%.3g\n", name_, size_, ( unsigned long long ) iterations, ns_per_op, bytes_per_op_ * 1'000'000'000.0 / ns_per_op, ( double ) allocations / ( double ) iterations, max_error_ );
+    std::fflush ( stdout );
+    return ns_per_op;
+}
+
+
+// Particles, one op is one 16 ms frame of the whole system, the bytes are
+// the vertices it writes.
+template<typename System>
+void benchmarkParticles ( const char * name_ ) {
+    for ( const std::size_t count : { 1'000u, 10'000u, 100'000u, 1'000'000u } ) {
+        System system ( ( sf::Uint32 ) count );
+        const sf::Time elapsed = sf::milliseconds ( 16 );
+        const sf::Color color ( 128, 128, 128 );
+        run ( name_, count, ( double ) ( count * sizeof ( sf::Vertex ) ), [ & ] ( ) {
+            system.update ( elapsed, color );
+        } );
+    }
+}
+
+
+// Animators of timers that keep animating (for the length of the benchmark),
+// the callbacks are bound as the INSTANCE_CALLBACK_* macros bind them. Emplace
+// fills an empty animator, run ticks all timers once, the bytes are the timers.
+struct Target {
+    float value = 0.0f;
+    void set ( const float value_ ) noexcept {
+        value += value_;
+    }
+};
+
+template<typename Animator>
+void benchmarkAnimator ( const char * emplace_name_, const char * run_name_ ) {
+    using namespace std::placeholders;
+    using Timer = typename Animator::Timer;
+    for ( const std::size_t count : { 100u, 1'000u, 10'000u, 100'000u } ) {
+        Target target;
+        Animator animator;
+        const auto fill = [ & ] ( ) {
+            for ( std::size_t i = 0u; i < count; ++i ) {
+                animator.emplace ( INSTANCE_CALLBACK_EASING_START_END_DURATION ( target, set, sf::easing::quadraticInOutEasing, 0.0f, 1.0f, 3'600'000 ) );
+            }
+        };
+        run ( emplace_name_, count, ( double ) ( count * sizeof ( Timer ) ), [ & ] ( ) {
+            animator.clear ( );
+            fill ( );
+        } );
+        animator.clear ( );
+        fill ( );
+        run ( run_name_, count, ( double ) ( count * sizeof ( Timer ) ), [ & ] ( ) {
+            animator.run ( );
+        } );
+        g_sink_float = target.value;
+    }
+}
+
+// Retargeting a random one of count running timers through its handle, as a
+// hover animation does on every mouse move. The bytes are 0.
+void benchmarkAnimatorRetarget ( ) {
+    using namespace std::placeholders;
+    for ( const std::size_t count : { 1'000u, 100'000u } ) {
+        Target target;
+        sf::DelegateAnimator animator;
+        std::vector<sf::DelegateAnimator::Handle> handles;
+        for ( std::size_t i = 0u; i < count; ++i ) {
+            handles.push_back ( animator.emplace ( INSTANCE_CALLBACK_EASING_START_END_DURATION ( target, set, sf::easing::quadraticInOutEasing, 0.0f, 1.0f, 3'600'000 ) ) );
+        }
+        std::uint32_t state = 1u;
+        run ( "animator_retarget", count, 0.0, [ & ] ( ) {
+            state = state * 1'664'525u + 1'013'904'223u;
+            animator.retarget ( handles [ ( state >> 8 ) % count ], ( float ) ( state & 255u ) );
+        } );
+        g_sink_size = animator.size ( );
+    }
+}
+
+// Concurrent timers run on the calling thread against run ( pool ) with a
+// threshold of 0, at doubling sizes. The crossover row reports the smallest
+// size from which the pool was faster at every larger size (0 if it never
+// was), the calibrated row the threshold run ( pool ) settles on by itself,
+// they should be close. The bytes are the timers.
+void benchmarkParallelAnimator ( ) {
+    sf::ThreadPool pool;
+    std::size_t crossover = 0u;
+    for ( std::size_t count = 256u; count <= 262'144u; count *= 2u ) {
+        std::vector<float> values ( count );
+        sf::DelegateAnimator animator;
+        animator.setParallelThreshold ( 0u );
+        for ( float & value : values ) {
+            animator.emplaceConcurrent ( [ &value ] ( const float v_ ) { value = v_; }, &sf::easing::quadraticInOutEasing::run<float>, 0.0f, 1.0f, std::chrono::hours { 1 } );
+        }
+        const double bytes = ( double ) ( count * sizeof ( sf::DelegateTimer ) );
+        const double serial = run ( "animator_run_concurrent_serial", count, bytes, [ & ] ( ) {
+            animator.run ( );
+        } );
+        const double parallel = run ( "animator_run_concurrent_parallel", count, bytes, [ & ] ( ) {
+            animator.run ( pool );
+        } );
+        if ( parallel > 0.0 and parallel < serial ) {
+            crossover = crossover ? crossover : count;
+        }
+        else {
+            crossover = 0u;
+        }
+        g_sink_float = values.back ( );
+    }
+    if ( not g_filter or std::strstr ( "animator_run_parallel_crossover", g_filter ) ) {
+        std::printf ( "animator_run_parallel_crossover,%zu,0,0,0,0,0\n", crossover );
+    }
+    if ( not g_filter or std::strstr ( "animator_run_parallel_calibrated", g_filter ) ) {
+        std::vector<float> values ( 65'536u );
+        sf::DelegateAnimator animator;
+        for ( float & value : values ) {
+            animator.emplaceConcurrent ( [ &value ] ( const float v_ ) { value = v_; }, &sf::easing::quadraticInOutEasing::run<float>, 0.0f, 1.0f, std::chrono::hours { 1 } );
+        }
+        for ( int i = 0; i < 64; ++i ) {
+            animator.run ( pool );
+        }
+        g_sink_float = values.back ( );
+        std::printf ( "animator_run_parallel_calibrated,%zu,0,0,0,0,0\n", animator.parallelThreshold ( ) );
+    }
+}
+
+// Staggered delayed timers, as the *_DELAY macros create them: the delays are
+// spread over an hour, about one timer starts per frame. The run hardly
+// touches memory, the bytes are 0.
+void benchmarkDelayedAnimator ( ) {
+    for ( const std::size_t count : { 1'000u, 10'000u, 100'000u } ) {
+        Target target;
+        sf::DelegateAnimator animator;
+        for ( std::size_t i = 0u; i < count; ++i ) {
+            animator.emplace ( INSTANCE_CALLBACK_EASING_START_END_DURATION_DELAY ( target, set, sf::easing::quadraticInOutEasing, 0.0f, 1.0f, 1'000, ( sf::Int32 ) ( i * 3'600'000u / count ) ) );
+        }
+        run ( "animator_run_delayed", count, 0.0, [ & ] ( ) {
+            animator.run ( );
+        } );
+        g_sink_float = target.value;
+    }
+}
+
+// An hour of animation replayed at 60 frames per second on a ManualClock,
+// count 1 second timers with their delays spread over the hour. One op is the
+// whole hour (about 216'000 frames), the bytes are the timers.
+void benchmarkReplayAnimator ( ) {
+    using Clock = sf::ManualClock<struct ReplayClock>;
+    using Animator = sf::Animator<sf::BasicCallbackTimer<sf::Delegate<void ( const float )>, Clock>>;
+    for ( const std::size_t count : { 1'000u, 10'000u } ) {
+        Target target;
+        Animator animator;
+        run ( "animator_replay_hour", count, ( double ) ( count * sizeof ( Animator::Timer ) ), [ & ] ( ) {
+            Clock::set ( sf::HrTimePoint { } );
+            for ( std::size_t i = 0u; i < count; ++i ) {
+                animator.emplace ( INSTANCE_CALLBACK_EASING_START_END_DURATION_DELAY ( target, set, sf::easing::quadraticInOutEasing, 0.0f, 1.0f, 1'000, ( sf::Int32 ) ( i * 3'600'000u / count ) ) );
+            }
+            while ( not animator.empty ( ) ) {
+                Clock::advance ( std::chrono::microseconds { 16'667 } );
+                animator.run ( );
+            }
+        } );
+        g_sink_float = target.value;
+    }
+}
+
+// BatchAnimator, the same tweens writing to bound floats and calling the
+// callbacks. Run ticks all tweens once, the bytes are the tween arrays.
+void benchmarkBatchAnimator ( ) {
+    using namespace std::placeholders;
+    using Animator = sf::BatchAnimator<sf::easing::quadraticInOutEasing>;
+    for ( const std::size_t count : { 100u, 1'000u, 10'000u, 100'000u } ) {
+        std::vector<float> values ( count );
+        Animator targets;
+        for ( float & value : values ) {
+            targets.emplace ( sf::easing::quadraticInOut, &value, 0.0f, 1.0f, std::chrono::hours { 1 } );
+        }
+        run ( "batch_animator_run_target", count, ( double ) ( count * ( 5u * sizeof ( float ) + sizeof ( float * ) ) ), [ & ] ( ) {
+            targets.run ( );
+        } );
+        Target target;
+        Animator callbacks;
+        for ( std::size_t i = 0u; i < count; ++i ) {
+            callbacks.emplace ( sf::easing::quadraticInOut, std::bind ( &Target::set, &target, _1 ), 0.0f, 1.0f, std::chrono::hours { 1 } );
+        }
+        run ( "batch_animator_run_callback", count, ( double ) ( count * ( 5u * sizeof ( float ) + sizeof ( Animator::Callback ) ) ), [ & ] ( ) {
+            callbacks.run ( );
+        } );
+        g_sink_float = values.back ( ) + target.value;
+    }
+}
+
+
+// A timeline of count tweens in a chain, 10 ms apart and 25 ms long (about
+// three active at any time). The seeks jump around the timeline, the runs
+// play it at 60 Hz on a manual clock, starting over at the end. The bytes are
+// 0, a seek touches a few tweens.
+void benchmarkTimeline ( ) {
+    using namespace std::placeholders;
+    using Clock = sf::ManualClock<struct TimelineClock>;
+    for ( const std::size_t count : { 100u, 1'000u, 10'000u, 100'000u } ) {
+        Target target;
+        sf::BasicTimeline<Clock> timeline;
+        timeline.reserve ( count );
+        for ( std::size_t i = 0u; i < count; ++i ) {
+            timeline.add ( std::chrono::milliseconds { i * 10u }, std::bind ( &Target::set, &target, _1 ), &sf::easing::quadraticInOutEasing::run<float>, 0.0f, 1.0f, std::chrono::milliseconds { 25 } );
+        }
+        const float duration = timeline.duration ( );
+        std::uint32_t state = 1u;
+        run ( "timeline_seek", count, 0.0, [ & ] ( ) {
+            state = state * 1'664'525u + 1'013'904'223u;
+            timeline.seek ( sf::FloatDuration { duration * ( float ) ( state >> 8 ) * ( 1.0f / 16'777'216.0f ) } );
+        } );
+        timeline.rewind ( );
+        timeline.play ( );
+        run ( "timeline_run", count, 0.0, [ & ] ( ) {
+            Clock::advance ( std::chrono::microseconds { 16'667 } );
+            if ( decltype ( timeline )::Status::finished == timeline.run ( ) ) {
+                timeline.play ( );
+            }
+        } );
+        g_sink_float = target.value;
+    }
+}
+
+
+// A colour fade of count sprites, one ColorTween per sprite against a float
+// DelegateTimer per channel (the way it had to be done before). The size is
+// the sprites, the bytes are the timers.
+void benchmarkColorTween ( ) {
+    for ( const std::size_t count : { 100u, 1'000u, 10'000u, 100'000u } ) {
+        std::vector<sf::Color> colors ( count );
+        sf::TweenAnimator<sf::Color> tweens;
+        for ( sf::Color & color : colors ) {
+            tweens.emplace ( [ &color ] ( const sf::Color & c_ ) { color = c_; }, &sf::easing::quadraticInOutEasing::run<float>, sf::Color::Transparent, sf::Color::White, std::chrono::hours { 1 } );
+        }
+        run ( "tween_run_color", count, ( double ) ( count * sizeof ( sf::ColorTween ) ), [ & ] ( ) {
+            tweens.run ( );
+        } );
+        sf::DelegateAnimator channels;
+        for ( sf::Color & color : colors ) {
+            for ( sf::Uint8 * channel : { &color.r, &color.g, &color.b, &color.a } ) {
+                channels.emplace ( [ channel ] ( const float c_ ) { *channel = ( sf::Uint8 ) ( c_ + 0.5f ); }, &sf::easing::quadraticInOutEasing::run<float>, 0.0f, 255.0f, std::chrono::hours { 1 } );
+            }
+        }
+        run ( "tween_run_color_channels", count, ( double ) ( 4u * count * sizeof ( sf::DelegateTimer ) ), [ & ] ( ) {
+            channels.run ( );
+        } );
+        g_sink_size = colors.back ( ).toInteger ( );
+    }
+}
+
+
+// Easings, the closed form (inlined) against EasingTable::evaluate with both
+// interpolations, on random positions in [ 0, 1 ]. The bytes are the positions
+// read and the values written.
+template<typename Easing>
+void benchmarkEasing ( const char * closed_name_, const char * linear_name_, const char * cubic_name_ ) {
+    const sf::EasingTable linear ( Easing { }, 256u, sf::EasingInterpolation::Linear ), cubic ( Easing { }, 256u, sf::EasingInterpolation::Cubic );
+    for ( const std::size_t count : { 1'024u, 65'536u } ) {
+        std::mt19937 rng ( 4u );
+        std::uniform_real_distribution<float> dis ( 0.0f, 1.0f );
+        std::vector<float> t ( count ), exact ( count ), out ( count );
+        for ( float & v : t ) {
+            v = dis ( rng );
+        }
+        const double bytes = ( double ) ( 2u * count * sizeof ( float ) );
+        run ( closed_name_, count, bytes, [ & ] ( ) {
+            for ( std::size_t i = 0u; i < count; ++i ) {
+                exact [ i ] = Easing::template run<float> ( t [ i ], 0.0f, 1.0f );
+            }
+        } );
+        const auto error = [ & ] ( ) {
+            double e = 0.0;
+            for ( std::size_t i = 0u; i < count; ++i ) {
+                e = std::max ( e, ( double ) std::abs ( out [ i ] - exact [ i ] ) );
+            }
+            return e;
+        };
+        linear.evaluate ( t.data ( ), out.data ( ), count );
+        run ( linear_name_, count, bytes, [ & ] ( ) {
+            linear.evaluate ( t.data ( ), out.data ( ), count );
+        }, error ( ) );
+        cubic.evaluate ( t.data ( ), out.data ( ), count );
+        run ( cubic_name_, count, bytes, [ & ] ( ) {
+            cubic.evaluate ( t.data ( ), out.data ( ), count );
+        }, error ( ) );
+    }
+}
+
+#define BENCHMARK_EASING( E ) benchmarkEasing<sf::easing::E##Easing> ( "easing_closed_" #E, "easing_table_linear_" #E, "easing_table_cubic_" #E )
+
+
+sf::CatmullRom::Points randomWalk ( const std::size_t count_ ) {
+    std::mt19937 rng ( 1u );
+    std::uniform_real_distribution<float> step ( -20.0f, 20.0f );
+    sf::CatmullRom::Points points;
+    sf::Point p ( 0.0f, 0.0f );
+    for ( std::size_t i = 0u; i < count_; ++i ) {
+        points.push_back ( p );
+        p += sf::Point ( 10.0f + step ( rng ), step ( rng ) );
+    }
+    return points;
+}
+
+// The largest deviation from distance_ of the arc length between consecutive
+// points of polyline_ (arc length spacing). The points are projected onto the
+// curve sampled 64 times per segment, within twice distance_ from the previous
+// point, not onto another turn of a loop. Far from the origin the float
+// coordinates limit the measure to about 0.01 px.
+float spacingError ( const sf::CatmullRom::Points & points_, const sf::CatmullRom::CoordinatesVector & polyline_, const float distance_ ) {
+    const sf::CatmullRom::CoordinatesVector curve = sf::CatmullRom::catmullRom ( points_, 64 );
+    std::vector<double> length ( curve.size ( ), 0.0 );
+    for ( std::size_t i = 1u; i < curve.size ( ); ++i ) {
+        const sf::Point c = curve [ i ] - curve [ i - 1u ];
+        length [ i ] = length [ i - 1u ] + std::hypot ( ( double ) c.x, ( double ) c.y );
+    }
+    double previous = 0.0, error = 0.0;
+    for ( std::size_t k = 1u, i = 0u; k < polyline_.size ( ); ++k ) {
+        float nearest = std::numeric_limits<float>::max ( );
+        double position = previous;
+        for ( std::size_t j = i; j + 1u < curve.size ( ) and length [ j ] < previous + 2.0 * distance_; ++j ) {
+            const sf::Point c = curve [ j + 1u ] - curve [ j ], w = polyline_ [ k ] - curve [ j ];
+            const float cc = c.x * c.x + c.y * c.y, t = cc > 0.0f ? std::clamp ( ( c.x * w.x + c.y * w.y ) / cc, 0.0f, 1.0f ) : 0.0f;
+            const float distance = std::hypot ( w.x - t * c.x, w.y - t * c.y );
+            if ( distance < nearest ) {
+                nearest = distance;
+                position = length [ j ] + t * ( length [ j + 1u ] - length [ j ] );
+                i = j;
+            }
+        }
+        error = std::max ( error, std::abs ( position - previous - distance_ ) );
+        previous = position;
+    }
+    return ( float ) error;
+}
+
+// Catmull-Rom, both overloads, the distance one with both spacings (arc
+// length table and the stepping search) and into a reused buffer, the bytes
+// are the curve points returned (written, for the trail). The interval one
+// also into a reused buffer on a thread pool. max_error of the arc length
+// spacing is its measured spacing error in px.
+void benchmarkCatmullRom ( ) {
+    sf::ThreadPool pool;
+    for ( const std::size_t count : { 16u, 256u, 4'096u } ) {
+        const sf::CatmullRom::Points points = randomWalk ( count );
+        const std::size_t interval_size = sf::CatmullRom::catmullRom ( points, 16 ).size ( );
+        run ( "catmull_rom_interval", count, ( double ) ( interval_size * sizeof ( sf::Point ) ), [ & ] ( ) {
+            g_sink_size = sf::CatmullRom::catmullRom ( points, 16 ).size ( );
+        } );
+        sf::CatmullRom::CoordinatesVector interval_buffer;
+        run ( "catmull_rom_interval_parallel", count, ( double ) ( interval_size * sizeof ( sf::Point ) ), [ & ] ( ) {
+            interval_buffer.clear ( );
+            sf::CatmullRom::catmullRom ( interval_buffer, points, 16, pool );
+            g_sink_size = interval_buffer.size ( );
+        } );
+        const sf::CatmullRom::CoordinatesVector distance_points = sf::CatmullRom::catmullRom ( points, 2.0f );
+        const std::size_t distance_size = distance_points.size ( );
+        run ( "catmull_rom_distance", count, ( double ) ( distance_size * sizeof ( sf::Point ) ), [ & ] ( ) {
+            g_sink_size = sf::CatmullRom::catmullRom ( points, 2.0f ).size ( );
+        }, spacingError ( points, distance_points, 2.0f ) );
+        sf::CatmullRom::CoordinatesVector buffer;
+        run ( "catmull_rom_distance_buffer", count, ( double ) ( distance_size * sizeof ( sf::Point ) ), [ & ] ( ) {
+            buffer.clear ( );
+            sf::CatmullRom::catmullRom ( buffer, points, 2.0f );
+            g_sink_size = buffer.size ( );
+        } );
+        // A trail of count points, a point appended per op (the oldest one dropped),
+        // against catmull_rom_interval regenerating all of it.
+        sf::CatmullRom::IncrementalSpline trail ( count, 16 );
+        for ( const sf::Point & point : points ) {
+            trail.push_back ( point );
+        }
+        std::size_t next = 0u;
+        run ( "catmull_rom_trail_push", count, ( double ) ( 2u * 16u * sizeof ( sf::Point ) ), [ & ] ( ) {
+            trail.push_back ( points [ next ] + sf::Point ( 0.0f, 1.0f ) );
+            next = ( next + 1u ) % count;
+            g_sink_size = trail.samples ( );
+        } );
+        const std::size_t search_size = sf::CatmullRom::catmullRom ( points, 2.0f, sf::CatmullRom::Spacing::chordSearch ).size ( );
+        run ( "catmull_rom_distance_search", count, ( double ) ( search_size * sizeof ( sf::Point ) ), [ & ] ( ) {
+            g_sink_size = sf::CatmullRom::catmullRom ( points, 2.0f, sf::CatmullRom::Spacing::chordSearch ).size ( );
+        } );
+    }
+}
+
+
+// A track of 30 px steps, straight but for a turn at about every 7th point.
+sf::CatmullRom::Points randomTrack ( const std::size_t count_ ) {
+    std::mt19937 rng ( 2u );
+    std::uniform_real_distribution<float> uniform ( 0.0f, 1.0f );
+    sf::CatmullRom::Points points;
+    sf::Point p ( 0.0f, 0.0f );
+    float heading = 0.0f;
+    for ( std::size_t i = 0u; i < count_; ++i ) {
+        points.push_back ( p );
+        if ( uniform ( rng ) < 0.15f ) {
+            heading += 3.0f * ( uniform ( rng ) - 0.5f );
+        }
+        p += sf::Point ( 30.0f * std::cos ( heading ), 30.0f * std::sin ( heading ) );
+    }
+    return points;
+}
+
+float distanceToSegment ( const sf::Point & p_, const sf::Point & a_, const sf::Point & b_ ) {
+    const sf::Point c = b_ - a_, w = p_ - a_;
+    const float cc = c.x * c.x + c.y * c.y, t = cc > 0.0f ? std::clamp ( ( c.x * w.x + c.y * w.y ) / cc, 0.0f, 1.0f ) : 0.0f;
+    return std::hypot ( w.x - t * c.x, w.y - t * c.y );
+}
+
+// The largest distance of the curve (256 samples per segment) from polyline_,
+// which passes through the control points.
+float chordalDeviation ( const sf::CatmullRom::Points & points_, const sf::CatmullRom::CoordinatesVector & polyline_ ) {
+    constexpr sf::Int32 samples = 256;
+    const sf::CatmullRom::CoordinatesVector curve = sf::CatmullRom::catmullRom ( points_, samples );
+    float deviation = 0.0f;
+    for ( std::size_t j = 0u, begin = 0u; j + 1u < points_.size ( ); ++j ) {
+        std::size_t end = begin + 1u;
+        while ( end + 1u < polyline_.size ( ) and polyline_ [ end ] != points_ [ j + 1u ] ) {
+            ++end;
+        }
+        for ( sf::Int32 i = 0; i < samples; ++i ) {
+            float nearest = std::numeric_limits<float>::max ( );
+            for ( std::size_t k = begin; k < end; ++k ) {
+                nearest = std::min ( nearest, distanceToSegment ( curve [ j * samples + i ], polyline_ [ k ], polyline_ [ k + 1u ] ) );
+            }
+            deviation = std::max ( deviation, nearest );
+        }
+        begin = end;
+    }
+    return deviation;
+}
+
+// Error against point count, on a track and on the random walk: adaptive
+// tessellation at a maximum deviation, against the fixed count per interval
+// with the fewest points as close to the curve. Unlike the other rows, size is
+// the number of points of the polyline and max_error its measured deviation in
+// px, the bytes are the polyline.
+void benchmarkCatmullRomTessellation ( ) {
+    for ( const bool track : { true, false } ) {
+        const sf::CatmullRom::Points points = track ? randomTrack ( 256u ) : randomWalk ( 256u );
+        for ( const float max_deviation : { 0.1f, 0.25f, 0.5f, 1.0f } ) {
+            sf::CatmullRom::CoordinatesVector polyline = sf::CatmullRom::catmullRomAdaptive ( points, max_deviation );
+            const float deviation = chordalDeviation ( points, polyline );
+            run ( track ? "catmull_rom_adaptive_track" : "catmull_rom_adaptive_walk", polyline.size ( ), ( double ) ( polyline.size ( ) * sizeof ( sf::Point ) ), [ & ] ( ) {
+                polyline.clear ( );
+                sf::CatmullRom::catmullRomAdaptive ( polyline, points, max_deviation );
+                g_sink_size = polyline.size ( );
+            }, deviation );
+            sf::Int32 n = 1;
+            for ( ; n < 256; ++n ) {
+                polyline.clear ( );
+                sf::CatmullRom::catmullRom ( polyline, points, n );
+                polyline.push_back ( points.back ( ) );
+                if ( chordalDeviation ( points, polyline ) <= deviation ) {
+                    break;
+                }
+            }
+            run ( track ? "catmull_rom_interval_matched_track" : "catmull_rom_interval_matched_walk", polyline.size ( ), ( double ) ( polyline.size ( ) * sizeof ( sf::Point ) ), [ & ] ( ) {
+                polyline.clear ( );
+                sf::CatmullRom::catmullRom ( polyline, points, n );
+                g_sink_size = polyline.size ( );
+            }, chordalDeviation ( points, polyline ) );
+        }
+    }
+}
+
+
+// Intersection of count pairs of random segments (about half intersect), the
+// bytes are the end points read.
+void benchmarkIntersection ( ) {
+    for ( const std::size_t count : { 1'000u, 100'000u } ) {
+        std::mt19937 rng ( 2u );
+        std::uniform_real_distribution<float> dis ( 0.0f, 100.0f );
+        std::vector<sf::Point> points ( 4u * count );
+        for ( sf::Point & p : points ) {
+            p = sf::Point ( dis ( rng ), dis ( rng ) );
+        }
+        run ( "line_segment_intersection", count, ( double ) ( points.size ( ) * sizeof ( sf::Point ) ), [ & ] ( ) {
+            std::size_t hits = 0u;
+            for ( std::size_t i = 0u; i < points.size ( ); i += 4u ) {
+                hits += sf::lineSegmentIntersection ( points [ i ], points [ i + 1u ], points [ i + 2u ], points [ i + 3u ] ).has_value ( );
+            }
+            g_sink_size = hits;
+        } );
+    }
+}
+
+
+// Text like (compressible) input, a multiple of 4 bytes for z85.
+std::string randomText ( const std::size_t size_ ) {
+    static const char words [ ] [ 8 ] = { "sfml ", "vertex ", "easing ", "timer ", "spline ", "point ", "stream ", "frame " };
+    std::mt19937 rng ( 3u );
+    std::string text;
+    text.reserve ( size_ + 8u );
+    while ( text.size ( ) < size_ ) {
+        text += words [ rng ( ) % 8u ];
+    }
+    text.resize ( size_ );
+    return text;
+}
+
+// Lz4 and z85, the bytes are the (uncompressed, unencoded) input.
+void benchmarkCodecs ( ) {
+    for ( const std::size_t size : { 4'096u, 65'536u, 1'048'576u } ) {
+        const std::string text = randomText ( size );
+        std::string decoded ( size, '\0' );
+        run ( "lz4_round_trip", size, ( double ) size, [ & ] ( ) {
+            std::stringstream compressed;
+            {
+                sf::LZ4OStream out ( compressed, sf::LZ4OStream::BEST_SPEED );
+                out.write ( text.data ( ), ( std::streamsize ) text.size ( ) );
+            }
+            sf::LZ4IStream in ( compressed );
+            in.read ( decoded.data ( ), ( std::streamsize ) decoded.size ( ) );
+            g_sink_size = ( std::size_t ) in.gcount ( );
+        } );
+        const std::string encoded = z85::encode ( text );
+        run ( "z85_encode", size, ( double ) size, [ & ] ( ) {
+            g_sink_size = z85::encode ( text ).size ( );
+        } );
+        run ( "z85_decode", size, ( double ) size, [ & ] ( ) {
+            g_sink_size = z85::decode ( encoded ).size ( );
+        } );
+    }
+}
+}
+
+
+int main ( int argc_, char ** argv_ ) {
+
+    if ( argc_ > 1 ) {
+        g_filter = argv_ [ 1 ];
+    }
+
+    std::printf ( "benchmark,size,iterations,ns_per_op,bytes_per_s,allocations_per_op,max_error\n" );
+
+    benchmarkParticles<sf::ParticleSystem> ( "particle_system_update" );
+    benchmarkParticles<sf::ParticleSystemSoA> ( "particle_system_soa_update" );
+    benchmarkAnimator<sf::CallbackAnimator> ( "animator_emplace_callback", "animator_run_callback" );
+    benchmarkAnimator<sf::DelegateAnimator> ( "animator_emplace_delegate", "animator_run_delegate" );
+    benchmarkAnimatorRetarget ( );
+    benchmarkParallelAnimator ( );
+    benchmarkDelayedAnimator ( );
+    benchmarkReplayAnimator ( );
+    benchmarkBatchAnimator ( );
+    benchmarkTimeline ( );
+    benchmarkColorTween ( );
+    BENCHMARK_EASING ( sinusoidalInOut );
+    BENCHMARK_EASING ( exponentialOut );
+    BENCHMARK_EASING ( circularInOut );
+    BENCHMARK_EASING ( elasticOut );
+    BENCHMARK_EASING ( bounceOut );
+    benchmarkCatmullRom ( );
+    benchmarkCatmullRomTessellation ( );
+    benchmarkIntersection ( );
+    benchmarkCodecs ( );
+
+    return 0;
+}
@@ -66,28 +66,7 @@ int main ( ) {
 
 namespace sf {
 
-CallbackTimer::CallbackTimer ( Callback && callback_, Easing easing_, const float start_, const float end_, const FloatDuration duration_, const std::chrono::milliseconds delay_ ) noexcept :
-    m_callback ( callback_ ),
-    m_easing ( easing_ ),
-    m_duration ( duration_.count ( ) ), m_start ( start_ ), m_end ( end_ ),
-    m_start_time ( s_clock.now ( ) + delay_ ) {
-
-}
-
-typename CallbackTimer::Status CallbackTimer::run ( ) noexcept {
-    float progress = std::chrono::duration < float > ( s_clock.now ( ) - m_start_time ).count ( );
-    if ( progress < 0.0f ) {
-        return Status::waiting;
-    }
-    progress /= m_duration;
-    if ( progress < 1.0f ) {
-        m_callback ( m_easing ( progress, m_start, m_end ) );
-        return Status::animating;
-    }
-    m_callback ( m_end );
-    return Status::finished;
-}
-
-HrClock CallbackTimer::s_clock;
+template struct BasicCallbackTimer<std::function<void ( const float )>>;
+template struct BasicCallbackTimer<Delegate<void ( const float )>>;
 
 }
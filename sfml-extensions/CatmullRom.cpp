@@ -22,37 +22,16 @@
 // SOFTWARE.
 
 #include "./Extensions/CatmullRom.hpp"
+#include "./Extensions/ThreadPool.hpp"
+#include "Simd.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <limits>
 
-// http://stackoverflow.com/questions/9489736/catmull-rom-curve-with-no-cusps-and-no-self-intersections/23980479#23980479
-
-
-namespace sf::CatmullRom {
-
-struct CubicPoly {
-
-    float c0, c1, c2, c3;
-
-    float evaluate ( const float t_ ) const noexcept {
-
-        const float t2 = t_ * t_;
-
-        return c0 + c1 * t_ + c2 * t2 + c3 * t2 * t_;
-    }
-};
 
-struct CubicPolyXY {
-
-    CubicPoly x, y;
-
-    Vector2f evaluate ( const float t_ ) const noexcept {
+// http://stackoverflow.com/questions/9489736/catmull-rom-curve-with-no-cusps-and-no-self-intersections/23980479#23980479
 
-        const float t2 = t_ * t_, t3 = t2 * t_;
-
-        return Vector2f { x.c0 + x.c1 * t_ + x.c2 * t2 + x.c3 * t3, y.c0 + y.c1 * t_ + y.c2 * t2 + y.c3 * t3 };
-    }
-};
-}
 
 namespace sf::CatmullRom::detail {
 
@@ -102,13 +81,24 @@ void nonuniformCatmullRom ( const Vector4f & v_, const Vector3f & dt_, CubicPoly
 
 void centripetalCatmullRom ( const Vector2f & p0_, const Vector2f & p1_, const Vector2f & p2_, const Vector2f & p3_, CubicPolyXY & cp_ ) noexcept {
 
-    const Vector3f dt { std::powf ( squaredLength ( p1_ - p0_ ), 0.25f ), std::powf ( squaredLength ( p2_ - p1_ ), 0.25f ), std::powf ( squaredLength ( p3_ - p2_ ), 0.25f ) };
+    const float d0 = squaredLength ( p1_ - p0_ ), d1 = squaredLength ( p2_ - p1_ ), d2 = squaredLength ( p3_ - p2_ );
+
+    // Repeated points, the divisions below would be 0 / 0 (not a number, which -ffast-math
+    // assumes away): a segment between coinciding points is that point, a coinciding
+    // neighbour takes the interval of the segment...
+
+    if ( 0.0f == d1 ) {
+
+        cp_.x = CubicPoly { p1_.x, 0.0f, 0.0f, 0.0f };
+        cp_.y = CubicPoly { p1_.y, 0.0f, 0.0f, 0.0f };
+
+        return;
+    }
 
-    // Safety check for repeated points...
+    Vector3f dt { 0.0f, std::powf ( d1, 0.25f ), 0.0f };
 
-    // if ( dt.y < 1e-4f ) dt.y = 1.0f;
-    // if ( dt.x < 1e-4f ) dt.x = dt.y;
-    // if ( dt.z < 1e-4f ) dt.z = dt.y;
+    dt.x = 0.0f == d0 ? dt.y : std::powf ( d0, 0.25f );
+    dt.z = 0.0f == d2 ? dt.y : std::powf ( d2, 0.25f );
 
     nonuniformCatmullRom ( Vector4f { p0_.x, p1_.x, p2_.x, p3_.x }, dt, cp_.x );
     nonuniformCatmullRom ( Vector4f { p0_.y, p1_.y, p2_.y, p3_.y }, dt, cp_.y );
@@ -244,129 +234,695 @@ inline void pointsOnSegment ( CoordinatesVector & return_value_, const CubicPoly
 
 #undef F40f
 
+
+// The arc length parameterisation of a segment: a table of the parameter,
+// the cumulative length and the speed (ds / dt) at increasing parameters.
+// The length of an interval is integrated with 5 point Gauss-Legendre (exact
+// for polynomials up to degree 9, the speed of a cubic is the root of a
+// quartic, smooth except near a cusp), an interval is halved until that
+// agrees with the sum of its halves, the halves sharing the tolerance of the
+// whole, so the table is within a quarter of the tolerance. An interval that
+// runs out of table is measured (and later integrated) the same way, without
+// a table entry per piece.
+// The points are found in order, each with a binary search in the table, a
+// guess from the cubic Hermite interpolant of the interval and safeguarded
+// Newton steps (bisection where Newton leaves the bracket) on the integral
+// from the previous point (or the interval start), where the length is known,
+// so the errors do not add up.
+
+struct ArcLength {
+
+    static constexpr Int32 initial_intervals = 2, max_intervals = 64, max_depth = 20, max_iterations = 32;
+
+    const CubicPolyXY & poly;
+    float tolerance;
+    float parameter [ max_intervals + 1 ], length [ max_intervals + 1 ], speed [ max_intervals + 1 ];
+    bool coarse [ max_intervals ]; // Did not converge within the table.
+    Int32 size = 0; // Intervals.
+
+    ArcLength ( const CubicPolyXY & poly_, const float tolerance_ ) noexcept : poly ( poly_ ), tolerance ( 0.25f * tolerance_ ) {
+
+        parameter [ 0 ] = length [ 0 ] = 0.0f;
+        speed [ 0 ] = poly.speed ( 0.0f );
+
+        for ( Int32 i = 0; i < initial_intervals; ++i ) {
+
+            const float a = ( float ) i / initial_intervals, b = ( float ) ( i + 1 ) / initial_intervals;
+
+            add ( a, b, integrate ( a, b ), speed [ size ], poly.speed ( b ), tolerance / initial_intervals, max_intervals / initial_intervals );
+        }
+    }
+
+    void add ( const float a_, const float b_, const float whole_, const float speed_a_, const float speed_b_, const float tolerance_, const Int32 budget_ ) noexcept {
+
+        const float m = 0.5f * ( a_ + b_ ), left = integrate ( a_, m ), right = integrate ( m, b_ );
+        const bool converged = agree ( whole_, left + right, tolerance_ );
+
+        if ( budget_ > 1 and not converged ) {
+
+            const float speed_m = poly.speed ( m );
+
+            add ( a_, m, left, speed_a_, speed_m, 0.5f * tolerance_, budget_ / 2 );
+            add ( m, b_, right, speed_m, speed_b_, 0.5f * tolerance_, budget_ / 2 );
+
+            return;
+        }
+
+        coarse [ size ] = not converged;
+        ++size;
+        parameter [ size ] = b_;
+        length [ size ] = length [ size - 1 ] + ( converged ? left + right : measure ( a_, m, left, 0.5f * tolerance_, max_depth ) + measure ( m, b_, right, 0.5f * tolerance_, max_depth ) );
+        speed [ size ] = speed_b_;
+    }
+
+    // Within tolerance_, or float precision, where halving does not help.
+
+    static bool agree ( const float whole_, const float parts_, const float tolerance_ ) noexcept {
+
+        return std::abs ( parts_ - whole_ ) <= std::max ( tolerance_, 8.0f * std::numeric_limits<float>::epsilon ( ) * std::abs ( whole_ ) );
+    }
+
+    // The length over [ a_, b_ ] (whole_ integrated at once) within tolerance_, halving.
+
+    float measure ( const float a_, const float b_, const float whole_, const float tolerance_, const Int32 depth_ ) const noexcept {
+
+        const float m = 0.5f * ( a_ + b_ ), left = integrate ( a_, m ), right = integrate ( m, b_ );
+
+        if ( not depth_ or agree ( whole_, left + right, tolerance_ ) ) {
+
+            return left + right;
+        }
+
+        return measure ( a_, m, left, 0.5f * tolerance_, depth_ - 1 ) + measure ( m, b_, right, 0.5f * tolerance_, depth_ - 1 );
+    }
+
+    float integrate ( const float a_, const float b_ ) const noexcept {
+
+        static constexpr float x [ 5 ] { 0.046910077f, 0.230765345f, 0.5f, 0.769234655f, 0.953089923f };
+        static constexpr float w [ 5 ] { 0.118463443f, 0.239314335f, 0.284444444f, 0.239314335f, 0.118463443f };
+
+        const float h = b_ - a_;
+        float sum = 0.0f;
+
+        for ( Int32 i = 0; i < 5; ++i ) {
+
+            sum += w [ i ] * poly.speed ( a_ + h * x [ i ] );
+        }
+
+        return sum * h;
+    }
+
+    float total ( ) const noexcept {
+
+        return length [ size ];
+    }
+
+    // The parameter at arc length s_, not less than the one of the previous
+    // call.
+
+    float next ( const float s_ ) noexcept {
+
+        const Int32 i = std::clamp ( ( Int32 ) ( std::upper_bound ( length + 1, length + size + 1, s_ ) - ( length + 1 ) ), 0, size - 1 );
+        const float h = parameter [ i + 1 ] - parameter [ i ], s0 = length [ i ], s1 = length [ i + 1 ], m0 = h * speed [ i ], m1 = h * speed [ i + 1 ];
+
+        // Hermite: s ( u ) = s0 + m0 u + c2 u^2 + c3 u^3, u in [ 0, 1 ].
+
+        const float c2 = 3.0f * ( s1 - s0 ) - 2.0f * m0 - m1, c3 = 2.0f * ( s0 - s1 ) + m0 + m1;
+
+        float u = s1 > s0 ? ( s_ - s0 ) / ( s1 - s0 ) : 0.0f;
+
+        for ( Int32 k = 0; k < 2; ++k ) {
+
+            const float e = s0 + ( m0 + ( c2 + c3 * u ) * u ) * u - s_, d = m0 + ( 2.0f * c2 + 3.0f * c3 * u ) * u;
+
+            if ( d <= 0.0f ) {
+
+                break;
+            }
+
+            u = std::clamp ( u - e / d, 0.0f, 1.0f );
+        }
+
+        // From the previous point, or from the start of the interval if that is before it.
+
+        if ( last_parameter < parameter [ i ] ) {
+
+            last_parameter = parameter [ i ];
+            last_length = length [ i ];
+        }
+
+        // The root is bracketed by [ lo, hi ], Newton steps that leave it bisect.
+
+        float lo = last_parameter, hi = parameter [ i + 1 ], t = std::clamp ( parameter [ i ] + h * u, lo, hi ), e = 0.0f;
+
+        for ( Int32 k = 0; ; ++k ) {
+
+            const float whole = integrate ( last_parameter, t );
+
+            e = last_length + ( coarse [ i ] ? measure ( last_parameter, t, whole, tolerance, max_depth ) : whole ) - s_;
+
+            if ( std::abs ( e ) <= tolerance or max_iterations == k ) {
+
+                break;
+            }
+
+            ( e < 0.0f ? lo : hi ) = t;
+
+            const float v = poly.speed ( t ), n = t - e / v, step = v > 0.0f and lo < n and n < hi ? n : 0.5f * ( lo + hi );
+
+            if ( step <= lo or hi <= step ) { // The bracket is down to adjacent floats...
+
+                break;
+            }
+
+            t = step;
+        }
+
+        last_parameter = t;
+        last_length = s_ + e;
+
+        return t;
+    }
+
+    // The previous point.
+    float last_parameter = 0.0f, last_length = 0.0f;
+};
+
+
+// Appends the points at arc length distance_ apart, carry_ is the length from
+// the last point to the start of the segment on entry, to its end on exit.
+
+inline void pointsOnSegmentArcLength ( CoordinatesVector & return_value_, const CubicPolyXY & poly_, const float distance_, float & carry_ ) noexcept {
+
+    ArcLength arc ( poly_, distance_ * spacing_tolerance );
+    const float total = arc.total ( );
+
+    if ( total <= 0.0f ) { // Coinciding points, nothing to add...
+
+        return;
+    }
+
+    float s = distance_ - carry_;
+
+    for ( ; s < total; s += distance_ ) {
+
+        return_value_.emplace_back ( poly_.evaluate ( arc.next ( s ) ) );
+    }
+
+    carry_ = total - ( s - distance_ );
 }
 
-namespace sf::CatmullRom {
 
-CoordinatesVector catmullRom ( const Points & points_, const Int32 number_of_points_per_interval_ ) noexcept {
+// Appends the end points of the pieces of poly_ over [ a_, b_ ] (from pa_ to pb_) that
+// are within max_deviation_ of their chord, halving the others. The curve lies in the
+// convex hull of the Bezier control points of the piece, so it is close enough if
+// they are...
 
-    // Calculate Catmull Rom for a chain of points and return the combined curve. The
-    // chains' first and last point are extrapolated from the second and 1-before-
-    // last point, respectively...
+inline bool deviates ( const Vector2f c_, const Vector2f w_, const float sqrd_deviation_ ) noexcept {
 
-    const Int32 number_of_intervals = ( Int32 ) points_.size ( ) - 1L; // -1 = -3 + 2 extrap.
-    const float rec = 1.0f / number_of_points_per_interval_;
+    // The distance of w_ from the chord [ 0, c_ ]...
+
+    const float cc = c_.x * c_.x + c_.y * c_.y, dot = c_.x * w_.x + c_.y * w_.y;
+
+    if ( dot < 0.0f ) {
+
+        return squaredLength ( w_ ) > sqrd_deviation_;
+    }
+
+    if ( dot > cc ) {
+
+        return squaredLength ( w_ - c_ ) > sqrd_deviation_;
+    }
+
+    const float cross = c_.x * w_.y - c_.y * w_.x;
+
+    return cross * cross > sqrd_deviation_ * cc;
+}
+
+void pointsOnSegmentAdaptive ( CoordinatesVector & return_value_, const CubicPolyXY & poly_, const float a_, const float b_, const Vector2f pa_, const Vector2f pb_, const float sqrd_deviation_, const Int32 depth_ ) noexcept {
+
+    const float h = ( b_ - a_ ) / 3.0f;
+    const Vector2f c = pb_ - pa_, p1 = h * poly_.derivative ( a_ ), p2 = c - h * poly_.derivative ( b_ );
+
+    if ( depth_ and ( deviates ( c, p1, sqrd_deviation_ ) or deviates ( c, p2, sqrd_deviation_ ) ) ) {
+
+        const float m = 0.5f * ( a_ + b_ );
+        const Vector2f pm = poly_.evaluate ( m );
+
+        pointsOnSegmentAdaptive ( return_value_, poly_, a_, m, pa_, pm, sqrd_deviation_, depth_ - 1 );
+        pointsOnSegmentAdaptive ( return_value_, poly_, m, b_, pm, pb_, sqrd_deviation_, depth_ - 1 );
+
+        return;
+    }
+
+    return_value_.emplace_back ( pb_ );
+}
+
+
+// Makes room for size_ more points, growing geometrically, so that appending
+// curves to a buffer does not reallocate on every call...
+
+inline void reserveMore ( CoordinatesVector & v_, const std::size_t size_ ) {
+
+    if ( v_.capacity ( ) < v_.size ( ) + size_ ) {
+
+        v_.reserve ( std::max ( v_.size ( ) + size_, 2 * v_.capacity ( ) ) );
+    }
+}
+
+
+// Calls f_ ( poly, end point ) for the segments of the chain, the ends are
+// extrapolated. Requires 2 points or more...
+
+template<typename F>
+void forEachSegment ( const Points & points_, F && f_ ) {
 
     CubicPolyXY poly;
 
-    CoordinatesVector r;
+    const std::size_t n = points_.size ( );
 
-    r.reserve ( number_of_intervals * number_of_points_per_interval_ );
+    if ( 2ULL == n ) {
 
-    if ( 1 == number_of_intervals ) { // 2 points...
+        centripetalCatmullRom ( 2.0f * points_ [ 0 ] - points_ [ 1 ], points_ [ 0 ], points_ [ 1 ], 2.0f * points_ [ 1 ] - points_ [ 0 ], poly );
+        f_ ( poly, points_ [ 1 ] );
 
-        // Extrapolate both ends...
+        return;
+    }
 
-        detail::centripetalCatmullRom ( 2.0f * points_ [ 0 ] - points_ [ 1 ], points_ [ 0 ], points_ [ 1 ], 2.0f * points_ [ 1 ] - points_ [ 0 ], poly );
+    centripetalCatmullRom ( 2.0f * points_ [ 0 ] - points_ [ 1 ], points_ [ 0 ], points_ [ 1 ], points_ [ 2 ], poly );
+    f_ ( poly, points_ [ 1 ] );
 
-        for ( Int32 i = 0; i < number_of_points_per_interval_; ++i ) {
+    for ( std::size_t j = 0, l = n - 3ULL; j < l; ++j ) {
 
-            r.emplace_back ( poly.evaluate ( rec * i ) );
+        centripetalCatmullRom ( points_ [ j ], points_ [ j + 1 ], points_ [ j + 2 ], points_ [ j + 3 ], poly );
+        f_ ( poly, points_ [ j + 2 ] );
+    }
+
+    centripetalCatmullRom ( points_ [ n - 3ULL ], points_ [ n - 2ULL ], points_ [ n - 1ULL ], 2.0f * points_ [ n - 1ULL ] - points_ [ n - 2ULL ], poly );
+    f_ ( poly, points_ [ n - 1ULL ] );
+}
+
+
+
+// Segment j_ of the chain, as forEachSegment computes it...
+
+inline void segment ( const Points & points_, const std::size_t j_, CubicPolyXY & poly_ ) noexcept {
+
+    const std::size_t n = points_.size ( );
+
+    const Vector2f p0 = j_ ? points_ [ j_ - 1ULL ] : 2.0f * points_ [ 0 ] - points_ [ 1 ];
+    const Vector2f p3 = j_ + 2ULL < n ? points_ [ j_ + 2ULL ] : 2.0f * points_ [ n - 1ULL ] - points_ [ n - 2ULL ];
+
+    centripetalCatmullRom ( p0, points_ [ j_ ], points_ [ j_ + 1ULL ], p3, poly_ );
+}
+
+
+// Samples [ begin_, end_ ) of poly_ at t = first_ + i * step_, in Horner form, into x_ and
+// y_, or interleaved into xy_ if not null. The vector kernels give the same results...
+
+static_assert ( sizeof ( Point ) == 2 * sizeof ( float ) );
+
+inline void evaluateScalar ( const CubicPolyXY & p_, const float first_, const float step_, const std::size_t begin_, const std::size_t end_, float * x_, float * y_, Point * xy_ ) noexcept {
+
+    for ( std::size_t i = begin_; i < end_; ++i ) {
+
+        const float t = first_ + step_ * ( float ) i;
+        const float x = ( ( p_.x.c3 * t + p_.x.c2 ) * t + p_.x.c1 ) * t + p_.x.c0, y = ( ( p_.y.c3 * t + p_.y.c2 ) * t + p_.y.c1 ) * t + p_.y.c0;
+
+        if ( xy_ ) {
+
+            xy_ [ i ] = Point { x, y };
+        }
+
+        else {
+
+            x_ [ i ] = x;
+            y_ [ i ] = y;
         }
     }
+}
 
-    else { // 3 points or more...
+#ifdef SFML_EXTENSIONS_X64
 
-        // Extrapolate...
+void evaluateSse2 ( const CubicPolyXY & p_, const float first_, const float step_, const std::size_t n_, float * x_, float * y_, Point * xy_ ) noexcept {
 
-        detail::centripetalCatmullRom ( 2.0f * points_ [ 0 ] - points_ [ 1 ], points_ [ 0 ], points_ [ 1 ], points_ [ 2 ], poly );
+    const __m128 first = _mm_set1_ps ( first_ ), step = _mm_set1_ps ( step_ ), lanes = _mm_setr_ps ( 0.0f, 1.0f, 2.0f, 3.0f );
+    const __m128 x0 = _mm_set1_ps ( p_.x.c0 ), x1 = _mm_set1_ps ( p_.x.c1 ), x2 = _mm_set1_ps ( p_.x.c2 ), x3 = _mm_set1_ps ( p_.x.c3 );
+    const __m128 y0 = _mm_set1_ps ( p_.y.c0 ), y1 = _mm_set1_ps ( p_.y.c1 ), y2 = _mm_set1_ps ( p_.y.c2 ), y3 = _mm_set1_ps ( p_.y.c3 );
 
-        for ( Int32 i = 0; i < number_of_points_per_interval_; ++i ) {
+    std::size_t i = 0;
 
-            r.emplace_back ( poly.evaluate ( rec * i ) );
+    for ( ; i + 4 <= n_; i += 4 ) {
+
+        const __m128 t = _mm_add_ps ( first, _mm_mul_ps ( step, _mm_add_ps ( _mm_set1_ps ( ( float ) i ), lanes ) ) );
+        const __m128 x = _mm_add_ps ( _mm_mul_ps ( _mm_add_ps ( _mm_mul_ps ( _mm_add_ps ( _mm_mul_ps ( x3, t ), x2 ), t ), x1 ), t ), x0 );
+        const __m128 y = _mm_add_ps ( _mm_mul_ps ( _mm_add_ps ( _mm_mul_ps ( _mm_add_ps ( _mm_mul_ps ( y3, t ), y2 ), t ), y1 ), t ), y0 );
+
+        if ( xy_ ) {
+
+            float * const o = reinterpret_cast<float *> ( xy_ + i );
+
+            _mm_storeu_ps ( o, _mm_unpacklo_ps ( x, y ) );
+            _mm_storeu_ps ( o + 4, _mm_unpackhi_ps ( x, y ) );
         }
 
-        // Calculate (only runs when 4 points or more)...
+        else {
 
-        for ( Int32 j = 0, l = ( Int32 ) points_.size ( ) - 3; j < l; ++j ) {
+            _mm_storeu_ps ( x_ + i, x );
+            _mm_storeu_ps ( y_ + i, y );
+        }
+    }
+
+    evaluateScalar ( p_, first_, step_, i, n_, x_, y_, xy_ );
+}
 
-            detail::centripetalCatmullRom ( points_ [ j ], points_ [ j + 1 ], points_ [ j + 2 ], points_ [ j + 3 ], poly );
+SFML_EXTENSIONS_TARGET_AVX2 void evaluateAvx2 ( const CubicPolyXY & p_, const float first_, const float step_, const std::size_t n_, float * x_, float * y_, Point * xy_ ) noexcept {
 
-            for ( Int32 i = 0; i < number_of_points_per_interval_; ++i ) {
+    const __m256 first = _mm256_set1_ps ( first_ ), step = _mm256_set1_ps ( step_ ), lanes = _mm256_setr_ps ( 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f );
+    const __m256 x0 = _mm256_set1_ps ( p_.x.c0 ), x1 = _mm256_set1_ps ( p_.x.c1 ), x2 = _mm256_set1_ps ( p_.x.c2 ), x3 = _mm256_set1_ps ( p_.x.c3 );
+    const __m256 y0 = _mm256_set1_ps ( p_.y.c0 ), y1 = _mm256_set1_ps ( p_.y.c1 ), y2 = _mm256_set1_ps ( p_.y.c2 ), y3 = _mm256_set1_ps ( p_.y.c3 );
 
-                r.emplace_back ( poly.evaluate ( rec * i ) );
-            }
+    std::size_t i = 0;
+
+    for ( ; i + 8 <= n_; i += 8 ) {
+
+        const __m256 t = _mm256_add_ps ( first, _mm256_mul_ps ( step, _mm256_add_ps ( _mm256_set1_ps ( ( float ) i ), lanes ) ) );
+        const __m256 x = _mm256_add_ps ( _mm256_mul_ps ( _mm256_add_ps ( _mm256_mul_ps ( _mm256_add_ps ( _mm256_mul_ps ( x3, t ), x2 ), t ), x1 ), t ), x0 );
+        const __m256 y = _mm256_add_ps ( _mm256_mul_ps ( _mm256_add_ps ( _mm256_mul_ps ( _mm256_add_ps ( _mm256_mul_ps ( y3, t ), y2 ), t ), y1 ), t ), y0 );
+
+        if ( xy_ ) {
+
+            // x0 y0 x1 y1 | x4 y4 x5 y5 and x2 y2 x3 y3 | x6 y6 x7 y7, then swap the middle halves.
+
+            const __m256 lo = _mm256_unpacklo_ps ( x, y ), hi = _mm256_unpackhi_ps ( x, y );
+            float * const o = reinterpret_cast<float *> ( xy_ + i );
+
+            _mm256_storeu_ps ( o, _mm256_permute2f128_ps ( lo, hi, 0x20 ) );
+            _mm256_storeu_ps ( o + 8, _mm256_permute2f128_ps ( lo, hi, 0x31 ) );
         }
 
-        // Extrapolate...
+        else {
 
-        detail::centripetalCatmullRom ( points_ [ number_of_intervals - 2 ], points_ [ number_of_intervals - 1 ], points_ [ number_of_intervals ], 2.0f * points_ [ number_of_intervals ] - points_ [ number_of_intervals - 1 ], poly );
+            _mm256_storeu_ps ( x_ + i, x );
+            _mm256_storeu_ps ( y_ + i, y );
+        }
+    }
 
-        for ( Int32 i = 0; i < number_of_points_per_interval_; ++i ) {
+    evaluateScalar ( p_, first_, step_, i, n_, x_, y_, xy_ );
+}
 
-            r.emplace_back ( poly.evaluate ( rec * i ) );
+#endif
+
+inline void evaluate ( const CubicPolyXY & p_, const float first_, const float step_, const std::size_t n_, float * x_, float * y_, Point * xy_ ) noexcept {
+
+#ifdef SFML_EXTENSIONS_X64
+    switch ( cpuSimdLevel ( ) ) {
+        case SimdLevel::AVX2: return evaluateAvx2 ( p_, first_, step_, n_, x_, y_, xy_ );
+        case SimdLevel::SSE2: return evaluateSse2 ( p_, first_, step_, n_, x_, y_, xy_ );
+        default: break;
+    }
+#endif
+    evaluateScalar ( p_, first_, step_, 0, n_, x_, y_, xy_ );
+}
+}
+
+namespace sf::CatmullRom {
+
+std::size_t estimateSize ( const Points & points_, const Int32 number_of_points_per_interval_ ) noexcept {
+
+    return ( points_.size ( ) - 1ULL ) * ( std::size_t ) number_of_points_per_interval_;
+}
+
+
+std::size_t estimateSize ( const Points & points_, const float distance_ ) noexcept {
+
+    // The length of the polygon (the curve is rarely much longer) in steps of distance_, plus
+    // a rounding step per segment and the first point...
+
+    return ( std::size_t ) ( length ( points_ ) / distance_ ) + points_.size ( ) + 1ULL;
+}
+
+
+void evaluate ( const CubicPolyXY & poly_, const float first_, const float step_, float * x_, float * y_, const std::size_t n_ ) noexcept {
+
+    detail::evaluate ( poly_, first_, step_, n_, x_, y_, nullptr );
+}
+
+
+void evaluate ( const CubicPolyXY & poly_, const float first_, const float step_, Point * out_, const std::size_t n_ ) noexcept {
+
+    detail::evaluate ( poly_, first_, step_, n_, nullptr, nullptr, out_ );
+}
+
+
+void catmullRom ( CoordinatesVector & return_value_, const Points & points_, const Int32 number_of_points_per_interval_ ) noexcept {
+
+    // Calculate Catmull Rom for a chain of points and append the combined curve. The
+    // chains' first and last point are extrapolated from the second and 1-before-
+    // last point, respectively...
+
+    assert ( 1ULL < points_.size ( ) );
+    assert ( 0 < number_of_points_per_interval_ );
+
+    if ( number_of_points_per_interval_ < 1 ) { // Nothing to sample, and not a huge size_t...
+
+        return;
+    }
+
+    const std::size_t n = ( std::size_t ) number_of_points_per_interval_, begin = return_value_.size ( ), size = estimateSize ( points_, number_of_points_per_interval_ );
+    const float rec = 1.0f / number_of_points_per_interval_;
+
+    detail::reserveMore ( return_value_, size );
+    return_value_.resize ( begin + size );
+
+    Point * out = return_value_.data ( ) + begin;
+
+    detail::forEachSegment ( points_, [ & out, n, rec ] ( const CubicPolyXY & poly_, const Vector2f ) {
+
+        detail::evaluate ( poly_, 0.0f, rec, n, nullptr, nullptr, out );
+        out += n;
+    } );
+}
+
+
+void catmullRom ( CoordinatesVector & return_value_, const Points & points_, const Int32 number_of_points_per_interval_, ThreadPool & pool_ ) {
+
+    // As above, the segments are independent...
+
+    assert ( 1ULL < points_.size ( ) );
+    assert ( 0 < number_of_points_per_interval_ );
+
+    if ( number_of_points_per_interval_ < 1 ) { // Nothing to sample, and not a huge size_t...
+
+        return;
+    }
+
+    const std::size_t n = ( std::size_t ) number_of_points_per_interval_, begin = return_value_.size ( ), segments = points_.size ( ) - 1ULL;
+    const float rec = 1.0f / number_of_points_per_interval_;
+
+    detail::reserveMore ( return_value_, segments * n );
+    return_value_.resize ( begin + segments * n );
+
+    Point * const out = return_value_.data ( ) + begin;
+
+    pool_.parallelFor ( ( segments + parallel_chunk_size - 1ULL ) / parallel_chunk_size, [ & points_, out, n, rec, segments ] ( const std::size_t c_ ) {
+
+        CubicPolyXY poly;
+
+        for ( std::size_t j = c_ * parallel_chunk_size, l = std::min ( j + parallel_chunk_size, segments ); j < l; ++j ) {
+
+            detail::segment ( points_, j, poly );
+            detail::evaluate ( poly, 0.0f, rec, n, nullptr, nullptr, out + j * n );
         }
+    } );
+}
+
+
+CoordinatesVector catmullRom ( const Points & points_, const Int32 number_of_points_per_interval_ ) noexcept {
+
+    CoordinatesVector r;
+
+    catmullRom ( r, points_, number_of_points_per_interval_ );
+
+    return r;
+}
+
+
+void catmullRom ( CoordinatesVector & return_value_, const Points & points_, float distance_, const Spacing spacing_ ) noexcept {
+
+    // Calculate Catmull Rom for a chain of points and append the combined curve. The
+    // chains' first and last point are extrapolated from the second and 1-before-
+    // last point, respectively...
+
+    assert ( 1ULL < points_.size ( ) );
+
+    detail::reserveMore ( return_value_, estimateSize ( points_, distance_ ) );
+    return_value_.emplace_back ( points_ [ 0 ] );
+
+    if ( Spacing::arcLength == spacing_ ) {
+
+        float carry = 0.0f;
+
+        detail::forEachSegment ( points_, [ & return_value_, distance_, & carry ] ( const CubicPolyXY & poly_, const Vector2f ) {
+
+            detail::pointsOnSegmentArcLength ( return_value_, poly_, distance_, carry );
+        } );
+    }
+
+    else {
+
+        // Square the distance, to avoid calculating a square root for length...
+
+        distance_ *= distance_;
+
+        detail::forEachSegment ( points_, [ & return_value_, distance_ ] ( const CubicPolyXY & poly_, const Vector2f end_ ) {
+
+            detail::pointsOnSegment ( return_value_, poly_, end_, distance_ );
+        } );
     }
+}
+
+
+CoordinatesVector catmullRom ( const Points & points_, const float distance_, const Spacing spacing_ ) noexcept {
+
+    CoordinatesVector r;
+
+    catmullRom ( r, points_, distance_, spacing_ );
 
     return r;
 }
 
 
-CoordinatesVector catmullRom ( const Points & points_, float distance_ ) noexcept {
+void catmullRomAdaptive ( CoordinatesVector & return_value_, const Points & points_, const float max_deviation_ ) noexcept {
 
-    // Calculate Catmull Rom for a chain of points and return the combined curve. The
+    // Calculate Catmull Rom for a chain of points and append the combined curve. The
     // chains' first and last point are extrapolated from the second and 1-before-
-    // last point, respectively. The returned points are at a distance of distance_
-    // (at least) away from each other... 	Requires 3 points or more...
+    // last point, respectively...
 
-    // Square the distance, to avoid calculating a square root for length...
+    assert ( 1ULL < points_.size ( ) );
+    assert ( 0.0f < max_deviation_ );
 
-    assert ( 2ULL < points_.size ( ) );
+    const float sqrd_deviation = max_deviation_ * max_deviation_;
 
-    distance_ *= distance_;
+    return_value_.emplace_back ( points_ [ 0 ] );
 
-    CubicPolyXY poly;
+    detail::forEachSegment ( points_, [ & return_value_, sqrd_deviation ] ( const CubicPolyXY & poly_, const Vector2f end_ ) {
+
+        detail::pointsOnSegmentAdaptive ( return_value_, poly_, 0.0f, 1.0f, return_value_.back ( ), end_, sqrd_deviation, max_subdivision_depth );
+    } );
+}
 
-    static std::vector<Vector2f> return_value;
 
-    // Prepare return_value...
+CoordinatesVector catmullRomAdaptive ( const Points & points_, const float max_deviation_ ) noexcept {
 
-    return_value.clear ( );
-    return_value.emplace_back ( points_ [ 0 ] );
+    CoordinatesVector r;
 
-    if ( 2ULL == points_.size ( ) ) {
+    catmullRomAdaptive ( r, points_, max_deviation_ );
 
-        // Extrapolate 2 points...
+    return r;
+}
+
+
+IncrementalSpline::IncrementalSpline ( const std::size_t capacity_, const Int32 number_of_points_per_interval_ ) :
+    m_capacity ( capacity_ ), m_mask ( std::bit_ceil ( capacity_ ) - 1ULL ), m_per_segment ( ( std::size_t ) number_of_points_per_interval_ ) {
+
+    assert ( 0ULL < capacity_ and 0 < number_of_points_per_interval_ );
+
+    m_points.resize ( m_mask + 1ULL );
+    m_segments.resize ( m_mask + 1ULL );
+    m_samples.resize ( ( m_mask + 1ULL ) * m_per_segment );
+}
 
-        detail::centripetalCatmullRom ( 2.0f * points_ [ 0 ] - points_ [ 1 ], points_ [ 0 ], points_ [ 1 ], 2.0f * points_ [ 1 ] - points_ [ 0 ], poly );
-        detail::pointsOnSegment ( return_value, poly, points_ [ 1 ], distance_ );
 
-        return return_value;
+void IncrementalSpline::push_back ( const Point & point_ ) noexcept {
+
+    if ( capacity ( ) == m_size ) {
+
+        pop_front ( );
     }
 
-    else {
+    m_points [ ( m_head + m_size++ ) & m_mask ] = point_;
 
-        // Extrapolate 3 points...
+    // The new last segment, and the one before it, which was extrapolated...
 
-        detail::centripetalCatmullRom ( 2.0f * points_ [ 0 ] - points_ [ 1 ], points_ [ 0 ], points_ [ 1 ], points_ [ 2 ], poly );
-        detail::pointsOnSegment ( return_value, poly, points_ [ 1 ], distance_ );
+    if ( 1ULL < m_size ) {
 
-        // Calculate (only runs when 4 points or more)...
+        update ( m_size - 2ULL );
+    }
 
-        for ( std::size_t j = 0, l = points_.size ( ) - 3ULL; j < l; ++j ) {
+    if ( 2ULL < m_size ) {
 
-            detail::centripetalCatmullRom ( points_ [ j ], points_ [ j + 1 ], points_ [ j + 2 ], points_ [ j + 3 ], poly );
-            detail::pointsOnSegment ( return_value, poly, points_ [ j + 2 ], distance_ );
-        }
+        update ( m_size - 3ULL );
+    }
+}
+
+
+void IncrementalSpline::pop_front ( ) noexcept {
+
+    assert ( m_size );
 
-        // Extrapolate back...
+    m_head = ( m_head + 1ULL ) & m_mask;
+    --m_size;
 
-        detail::centripetalCatmullRom ( points_ [ points_.size ( ) - ( std::size_t ) 3 ], points_ [ points_.size ( ) - ( std::size_t ) 2 ], points_ [ points_.size ( ) - ( std::size_t ) 1 ], 2.0f * points_ [ points_.size ( ) - ( std::size_t ) 1 ] - points_ [ points_.size ( ) - ( std::size_t ) 2 ], poly );
-        detail::pointsOnSegment ( return_value, poly, points_ [ points_.size ( ) - ( std::size_t ) 1 ], distance_ );
+    // The new first segment, now extrapolated...
 
-        return return_value;
+    if ( 1ULL < m_size ) {
+
+        update ( 0ULL );
     }
 }
+
+
+void IncrementalSpline::clear ( ) noexcept {
+
+    m_head = m_size = 0ULL;
+}
+
+
+std::span<const Point> IncrementalSpline::first ( ) const noexcept {
+
+    const std::size_t begin = m_head * m_per_segment;
+
+    return { m_samples.data ( ) + begin, std::min ( samples ( ), m_samples.size ( ) - begin ) };
+}
+
+
+std::span<const Point> IncrementalSpline::second ( ) const noexcept {
+
+    return { m_samples.data ( ), samples ( ) - first ( ).size ( ) };
+}
+
+
+Point IncrementalSpline::point ( const std::ptrdiff_t i_ ) const noexcept {
+
+    const std::ptrdiff_t n = ( std::ptrdiff_t ) m_size;
+
+    if ( i_ < 0 ) {
+
+        return 2.0f * ( *this ) [ 0ULL ] - ( *this ) [ 1ULL ];
+    }
+
+    if ( i_ == n ) {
+
+        return 2.0f * ( *this ) [ n - 1 ] - ( *this ) [ n - 2 ];
+    }
+
+    return ( *this ) [ i_ ];
+}
+
+
+void IncrementalSpline::update ( const std::size_t i_ ) noexcept {
+
+    const std::ptrdiff_t i = ( std::ptrdiff_t ) i_;
+    const std::size_t slot = ( m_head + i_ ) & m_mask;
+    const float rec = 1.0f / m_per_segment;
+
+    CubicPolyXY & poly = m_segments [ slot ];
+
+    detail::centripetalCatmullRom ( point ( i - 1 ), point ( i ), point ( i + 1 ), point ( i + 2 ), poly );
+
+    detail::evaluate ( poly, 0.0f, rec, m_per_segment, nullptr, nullptr, m_samples.data ( ) + slot * m_per_segment );
+}
 }
 
 #if 0
@@ -0,0 +1,112 @@
+
+// MIT License
+//
+// Copyright (c) 2019 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cmath>
+
+#include "Extensions/EasingTable.hpp"
+#include "Simd.hpp"
+
+namespace sf {
+
+namespace {
+
+// Linear or Catmull-Rom interpolation in the samples s_ [ -1, size_ + 1 ].
+inline float interpolate ( const float * s_, const Uint32 size_, const bool cubic_, const float t_ ) noexcept {
+    const float p = std::clamp ( t_, 0.0f, 1.0f ) * ( float ) size_;
+    const Int32 i = std::min ( ( Int32 ) p, ( Int32 ) size_ - 1 );
+    const float f = p - ( float ) i;
+    const float p1 = s_ [ i ], p2 = s_ [ i + 1 ];
+    if ( not cubic_ ) {
+        return p1 + f * ( p2 - p1 );
+    }
+    const float p0 = s_ [ i - 1 ], p3 = s_ [ i + 2 ];
+    return p1 + 0.5f * f * ( p2 - p0 + f * ( 2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3 + f * ( 3.0f * ( p1 - p2 ) + p3 - p0 ) ) );
+}
+
+void evaluateScalar ( const float * s_, const Uint32 size_, const bool cubic_, const float * t_, float * out_, const std::size_t n_ ) noexcept {
+    for ( std::size_t i = 0; i < n_; ++i ) {
+        out_ [ i ] = interpolate ( s_, size_, cubic_, t_ [ i ] );
+    }
+}
+
+#ifdef SFML_EXTENSIONS_X64
+
+SFML_EXTENSIONS_TARGET_AVX2 void evaluateAvx2 ( const float * s_, const Uint32 size_, const bool cubic_, const float * t_, float * out_, const std::size_t n_ ) noexcept {
+    const __m256 zero = _mm256_setzero_ps ( ), one = _mm256_set1_ps ( 1.0f ), size = _mm256_set1_ps ( ( float ) size_ );
+    const __m256i last = _mm256_set1_epi32 ( ( int ) size_ - 1 ), one_i = _mm256_set1_epi32 ( 1 );
+    std::size_t i = 0;
+    for ( ; i + 8 <= n_; i += 8 ) {
+        const __m256 p = _mm256_mul_ps ( _mm256_min_ps ( _mm256_max_ps ( _mm256_loadu_ps ( t_ + i ), zero ), one ), size );
+        const __m256i k = _mm256_min_epi32 ( _mm256_cvttps_epi32 ( p ), last );
+        const __m256 f = _mm256_sub_ps ( p, _mm256_cvtepi32_ps ( k ) );
+        const __m256 p1 = _mm256_i32gather_ps ( s_, k, 4 ), p2 = _mm256_i32gather_ps ( s_ + 1, k, 4 );
+        if ( not cubic_ ) {
+            _mm256_storeu_ps ( out_ + i, _mm256_add_ps ( p1, _mm256_mul_ps ( f, _mm256_sub_ps ( p2, p1 ) ) ) );
+            continue;
+        }
+        const __m256 p0 = _mm256_i32gather_ps ( s_, _mm256_sub_epi32 ( k, one_i ), 4 ), p3 = _mm256_i32gather_ps ( s_ + 2, k, 4 );
+        // 3 ( p1 - p2 ) + p3 - p0, 2 p0 - 5 p1 + 4 p2 - p3 and p2 - p0, in Horner form.
+        __m256 c = _mm256_add_ps ( _mm256_mul_ps ( _mm256_set1_ps ( 3.0f ), _mm256_sub_ps ( p1, p2 ) ), _mm256_sub_ps ( p3, p0 ) );
+        c = _mm256_add_ps ( _mm256_mul_ps ( f, c ), _mm256_sub_ps ( _mm256_add_ps ( _mm256_add_ps ( p0, p0 ), _mm256_mul_ps ( _mm256_set1_ps ( 4.0f ), p2 ) ), _mm256_add_ps ( _mm256_mul_ps ( _mm256_set1_ps ( 5.0f ), p1 ), p3 ) ) );
+        c = _mm256_add_ps ( _mm256_mul_ps ( f, c ), _mm256_sub_ps ( p2, p0 ) );
+        _mm256_storeu_ps ( out_ + i, _mm256_add_ps ( p1, _mm256_mul_ps ( _mm256_mul_ps ( _mm256_set1_ps ( 0.5f ), f ), c ) ) );
+    }
+    evaluateScalar ( s_, size_, cubic_, t_ + i, out_ + i, n_ - i );
+}
+
+#endif
+}
+
+
+EasingTable::EasingTable ( const Easing easing_, const Uint32 size_, const EasingInterpolation interpolation_ ) :
+    m_table ( std::max ( size_, 1u ) + 3u ), m_size ( std::max ( size_, 1u ) ), m_interpolation ( interpolation_ ), m_max_error ( 0.0f ) {
+    float * const s = m_table.data ( ) + 1;
+    for ( Uint32 i = 0; i <= m_size; ++i ) {
+        s [ i ] = easing_ ( ( float ) i / ( float ) m_size, 0.0f, 1.0f );
+    }
+    // Quadratic extrapolation, so the spline follows the curvature at the ends.
+    s [ -1 ] = m_size > 1u ? 3.0f * ( s [ 0 ] - s [ 1 ] ) + s [ 2 ] : 2.0f * s [ 0 ] - s [ 1 ];
+    s [ m_size + 1 ] = m_size > 1u ? 3.0f * ( s [ m_size ] - s [ m_size - 1 ] ) + s [ m_size - 2 ] : 2.0f * s [ m_size ] - s [ m_size - 1 ];
+    const Uint32 checks = 16u * m_size;
+    for ( Uint32 i = 0; i <= checks; ++i ) {
+        const float t = ( float ) i / ( float ) checks;
+        m_max_error = std::max ( m_max_error, std::abs ( ( *this ) ( t ) - easing_ ( t, 0.0f, 1.0f ) ) );
+    }
+}
+
+float EasingTable::operator ( ) ( const float position_ ) const noexcept {
+    return interpolate ( m_table.data ( ) + 1, m_size, EasingInterpolation::Cubic == m_interpolation, position_ );
+}
+
+void EasingTable::evaluate ( const float * t_, float * out_, const std::size_t n_ ) const noexcept {
+#ifdef SFML_EXTENSIONS_X64
+    if ( SimdLevel::AVX2 == cpuSimdLevel ( ) ) {
+        evaluateAvx2 ( m_table.data ( ) + 1, m_size, EasingInterpolation::Cubic == m_interpolation, t_, out_, n_ );
+        return;
+    }
+#endif
+    evaluateScalar ( m_table.data ( ) + 1, m_size, EasingInterpolation::Cubic == m_interpolation, t_, out_, n_ );
+}
+
+}
@@ -21,6 +21,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <cfloat>
 #include <chrono>
 #include <cmath>
 
@@ -95,6 +96,52 @@ std::string systemTime ( ) noexcept {
 }
 
 
+#if ( defined ( _M_X64 ) or defined ( __x86_64__ ) ) and defined ( _MSC_VER )
+// The os enabled state components (xcr0), clang wants the xsave target for _xgetbv.
+#    if defined ( __clang__ )
+__attribute__ ( ( target ( "xsave" ) ) )
+#    endif
+static unsigned long long xcr0 ( ) noexcept {
+    return _xgetbv ( 0 );
+}
+#endif
+
+static SimdLevel cpu_simd_level_impl ( ) noexcept {
+#if defined ( _M_X64 ) or defined ( __x86_64__ )
+    // Sse2 is part of x64.
+#    if defined ( _MSC_VER )
+    int info [ 4 ];
+    __cpuid ( info, 0 );
+    if ( info [ 0 ] < 7 ) {
+        return SimdLevel::SSE2;
+    }
+    __cpuid ( info, 1 );
+    // Avx and xgetbv (osxsave).
+    if ( ( info [ 2 ] & ( 1 << 28 ) ) == 0 or ( info [ 2 ] & ( 1 << 27 ) ) == 0 ) {
+        return SimdLevel::SSE2;
+    }
+    // The os saves the xmm and ymm state (xcr0 bits 1 and 2).
+    if ( ( xcr0 ( ) & 6ULL ) != 6ULL ) {
+        return SimdLevel::SSE2;
+    }
+    __cpuidex ( info, 7, 0 );
+    return info [ 1 ] & ( 1 << 5 ) ? SimdLevel::AVX2 : SimdLevel::SSE2;
+#    else
+    return __builtin_cpu_supports ( "avx2" ) ? SimdLevel::AVX2 : SimdLevel::SSE2;
+#    endif
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+SimdLevel cpuSimdLevel ( ) noexcept {
+    static const SimdLevel level ( cpu_simd_level_impl ( ) );
+    return level;
+}
+
+
+#if defined ( _WIN32 )
+
 void makeWindowSeeThrough ( RenderWindowRef window ) noexcept {
     // https://en.sfml-dev.org/forums/index.php?topic=21118.msg150860#msg150860
     HWND hwnd = window.getSystemHandle ( );
@@ -179,6 +226,8 @@ Int32 getScreenRefreshRate ( ) noexcept {
     return srr;
 }
 
+#endif
+
 
 static ScreenSizeType screen_size_type_impl ( ) noexcept {
     const Uint32 height = sf::VideoMode::getDesktopMode ( ).height;
@@ -359,6 +408,8 @@ std::optional<Point> lineSegmentIntersectionStrict ( const Point & p0_, const Po
 }
 
 
+#if defined ( _WIN32 )
+
 std::string loadFromResource ( const Int32 name_ ) {
     // Loads text from a_ resource (.rc) file and return it as a_ string.
     HRSRC rsrc_data = FindResource ( NULL, MAKEINTRESOURCE ( name_ ), L"FILEDATA" );
@@ -485,4 +536,6 @@ IntDuration Pacer::now ( ) noexcept {
     // static const std::chrono::nanoseconds start { __rdtscp ( &m_ui ) };
     return std::chrono::nanoseconds { __rdtscp ( &m_ui ) };
 }
+
+#endif
 }
@@ -80,10 +80,18 @@
 #include "Extensions/Extensions.hpp"
 #include "Extensions/LZ4Stream.hpp"
 #include "Extensions/Box.hpp"
+#include "Extensions/Delegate.hpp"
 #include "Extensions/Animation.hpp"
+#include "Extensions/BatchAnimator.hpp"
+#include "Extensions/Tween.hpp"
+#include "Extensions/Timeline.hpp"
+#include "Extensions/EasingTable.hpp"
 #include "Extensions/Nanotimer.hpp"
 #include "Extensions/Owningptr.hpp"
 #include "Extensions/Serialize.hpp"
 #include "Extensions/CatmullRom.hpp"
 #include "Extensions/Z85.hpp"
 #include "Extensions/ParticleSystem.hpp"
+#include "Extensions/ThreadPool.hpp"
+#include "Extensions/ParticleAffectors.hpp"
+#include "Extensions/ParticleBatch.hpp"
@@ -23,15 +23,24 @@
 
 #pragma once
 
+#include <cassert>
 #include <cmath>
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <thread>
 #include <type_traits>
+#include <vector>
 
 #include <plf/plf_colony.h>
 
 #include "Extensions.hpp"
+#include "Delegate.hpp"
+#include "ThreadPool.hpp"
 
 
 namespace sf {
@@ -641,11 +650,96 @@ struct easing {
 };
 
 
-struct CallbackTimer {
+// Clocks for the timers and animators: a static now ( ) on the HrClock time
+// line. ManualClock only moves when the caller steps it, for deterministic
+// replays and headless tests (hours of animation in milliseconds),
+// ScaledClock runs at a settable rate of real time, for slow-motion and pause
+// of everything on it. The tag makes independent clocks of the same kind.
+// Neither is thread safe, step them on the thread that runs the animators.
+template<typename Tag = void>
+struct ManualClock {
+
+    using duration = HrClock::duration;
+    using rep = HrClock::rep;
+    using period = HrClock::period;
+    using time_point = HrTimePoint;
+
+    static constexpr bool is_steady = true;
+
+    static HrTimePoint now ( ) noexcept {
+        return s_now;
+    }
+
+    template<typename Rep, typename Period>
+    static void advance ( const std::chrono::duration<Rep, Period> step_ ) noexcept {
+        s_now += std::chrono::duration_cast<duration> ( step_ );
+    }
+
+    static void set ( const HrTimePoint now_ ) noexcept {
+        s_now = now_;
+    }
+
+    private:
+
+    static inline HrTimePoint s_now { };
+};
+
+template<typename Tag = void>
+struct ScaledClock {
+
+    using duration = HrClock::duration;
+    using rep = HrClock::rep;
+    using period = HrClock::period;
+    using time_point = HrTimePoint;
+
+    static constexpr bool is_steady = false;
+
+    static HrTimePoint now ( ) noexcept {
+        return at ( HrClock::now ( ) );
+    }
+
+    // 1 is real time, 0.5 half speed, 0 paused.
+    static void setScale ( const float scale_ ) noexcept {
+        const HrTimePoint real = HrClock::now ( );
+        State & state = get ( );
+        state.base = at ( real );
+        state.real_base = real;
+        state.scale = scale_;
+    }
+
+    static float getScale ( ) noexcept {
+        return get ( ).scale;
+    }
+
+    private:
+
+    // The scaled time base at the real time real_base.
+    struct State {
+        explicit State ( const HrTimePoint now_ ) noexcept : base ( now_ ), real_base ( now_ ) { }
+        HrTimePoint base, real_base;
+        float scale = 1.0f;
+    };
+
+    // Initialized on first use, also from the initializer of a global.
+    static State & get ( ) noexcept {
+        static State state { HrClock::now ( ) };
+        return state;
+    }
+
+    static HrTimePoint at ( const HrTimePoint real_ ) noexcept {
+        const State & state = get ( );
+        return state.base + std::chrono::duration_cast<duration> ( std::chrono::duration<double, period> ( real_ - state.real_base ) * ( double ) state.scale );
+    }
+};
+
+
+template<typename CallbackType, typename ClockType = HrClock>
+struct BasicCallbackTimer {
 
     enum class Status : Int32 { waiting, animating, finished };
 
-    using Callback = std::function < void ( const float ) >;
+    using Callback = CallbackType;
+    using Clock = ClockType;
     using Easing = float ( * ) ( float, const float, const float );
 
     Callback m_callback;
@@ -653,14 +747,72 @@ struct CallbackTimer {
     float m_duration, m_start, m_end;
     HrTimePoint m_start_time;
 
-    CallbackTimer ( Callback && callback_, Easing easing_, const float start_, const float end_, const FloatDuration duration_, const std::chrono::milliseconds delay_ = std::chrono::milliseconds { 0 } ) noexcept;
+    BasicCallbackTimer ( Callback && callback_, Easing easing_, const float start_, const float end_, const FloatDuration duration_, const std::chrono::milliseconds delay_ = std::chrono::milliseconds { 0 } ) noexcept;
 
     Status run ( ) noexcept;
+    // At time now_, f.e. the frame time, shared by all timers of the frame.
+    Status run ( const HrTimePoint now_ ) noexcept;
 
-    private:
+    // The end of the delay.
+    HrTimePoint startTime ( ) const noexcept {
+        return m_start_time;
+    }
 
-    static HrClock s_clock;
+    // 0 before the start, 1 at the end.
+    float progress ( const HrTimePoint now_ ) const noexcept {
+        return std::clamp ( std::chrono::duration < float > ( now_ - m_start_time ).count ( ) / m_duration, 0.0f, 1.0f );
+    }
+
+    // Tweens from the value at now_ to end_, in the full duration. Before the
+    // start only the end changes.
+    void retarget ( const float end_, const HrTimePoint now_ ) noexcept {
+        if ( now_ > m_start_time ) {
+            m_start = m_easing ( progress ( now_ ), m_start, m_end );
+            m_start_time = now_;
+        }
+        m_end = end_;
+    }
+
+    void postpone ( const HrClock::duration duration_ ) noexcept {
+        m_start_time += duration_;
+    }
 };
+
+template<typename CallbackType, typename Clock>
+BasicCallbackTimer<CallbackType, Clock>::BasicCallbackTimer ( Callback && callback_, Easing easing_, const float start_, const float end_, const FloatDuration duration_, const std::chrono::milliseconds delay_ ) noexcept :
+    m_callback ( std::move ( callback_ ) ),
+    m_easing ( easing_ ),
+    m_duration ( duration_.count ( ) ), m_start ( start_ ), m_end ( end_ ),
+    m_start_time ( Clock::now ( ) + delay_ ) {
+
+}
+
+template<typename CallbackType, typename Clock>
+typename BasicCallbackTimer<CallbackType, Clock>::Status BasicCallbackTimer<CallbackType, Clock>::run ( ) noexcept {
+    return run ( Clock::now ( ) );
+}
+
+template<typename CallbackType, typename Clock>
+typename BasicCallbackTimer<CallbackType, Clock>::Status BasicCallbackTimer<CallbackType, Clock>::run ( const HrTimePoint now_ ) noexcept {
+    float progress = std::chrono::duration < float > ( now_ - m_start_time ).count ( );
+    if ( progress < 0.0f ) {
+        return Status::waiting;
+    }
+    progress /= m_duration;
+    if ( progress < 1.0f ) {
+        m_callback ( m_easing ( progress, m_start, m_end ) );
+        return Status::animating;
+    }
+    m_callback ( m_end );
+    return Status::finished;
+}
+
+using CallbackTimer = BasicCallbackTimer<std::function<void ( const float )>>;
+// The callback is stored inline, creating (or copying) a timer never allocates.
+using DelegateTimer = BasicCallbackTimer<Delegate<void ( const float )>>;
+
+extern template struct BasicCallbackTimer<std::function<void ( const float )>>;
+extern template struct BasicCallbackTimer<Delegate<void ( const float )>>;
 }
 
 
@@ -679,36 +831,205 @@ struct CallbackTimer {
 
 namespace sf {
 
-template<typename Timer>
+// A handle to a timer in an Animator, from emplace. It stays valid until the
+// timer finishes or is cancelled, after that the operations on it do nothing
+// (the slot it refers to carries a generation, that is checked).
+struct AnimatorHandle {
+
+    Uint32 index = std::numeric_limits<Uint32>::max ( ), generation = 0u;
+
+    explicit operator bool ( ) const noexcept {
+        return std::numeric_limits<Uint32>::max ( ) != index;
+    }
+};
+
+// Timers with a delay wait in a min-heap on their start time, run only moves
+// the ones that are due into the active timers, so the cost of a run is
+// proportional to the active timers (plus log pending per timer started).
+// The clock is the one of the timers, f.e. a deterministic animator:
+//
+//     using ReplayAnimator = sf::Animator<sf::BasicCallbackTimer<sf::Delegate<void ( const float )>, sf::ManualClock<>>>;
+//
+// Every timer has a slot, that points at it in one of the colonies (their
+// iterators are stable) and that the handles index, so cancel, pause, resume,
+// retarget and progress are O ( 1 ):
+//
+//     hover = animator.emplace ( ... );
+//     animator.retarget ( hover, 1.2f ); // On every mouse move, no new timer.
+//
+// Timers from emplaceConcurrent have callbacks that may be called on any
+// thread (f.e. they only write to their own object), run ( pool ) runs them
+// in chunks on the pool, once there are at least parallelThreshold ( ) of
+// them (calibrated at run time). The other timers are always run on the
+// calling thread.
+//
+// The callback of a timer from emplace may use the animator: a timer it
+// cancels (itself included) is removed by the running loop, a timer it
+// emplaces starts at the next run. The callback of a concurrent timer must
+// not use the animator at all (asserted), on the pool it runs on a worker,
+// next to the other concurrent callbacks.
+template<typename TimerType>
 class Animator {
 
 public:
 
-    using Timers = plf::colony<Timer>;
+    using Timer = TimerType;
+    using Handle = AnimatorHandle;
+
+    // The timers a task of run ( pool ) runs.
+    static constexpr std::size_t parallel_chunk_size = 1'024u;
 
 private:
 
-    Timers m_timers;
+    struct Entry {
+        Timer timer;
+        Uint32 slot;
+        bool concurrent = false, paused = false;
+        bool cancelled = false; // During a run, the loop removes it.
+        HrTimePoint paused_at { };
+    };
+
+    using Timers = plf::colony<Entry>;
+
+    enum class Where : Uint8 { waiting, serial, concurrent };
+
+    struct Slot {
+        typename Timers::iterator it;
+        Uint32 index = 0u; // In m_concurrent.
+        Uint32 generation = 0u;
+        bool live = false;
+        Where where = Where::serial;
+    };
+
+    struct Pending {
+        HrTimePoint start_time;
+        Uint32 slot, generation;
+    };
+
+    Timers m_timers, m_waiting;
+    // Dense, so it can be split in chunks, erase moves the last one in.
+    std::vector<Entry> m_concurrent;
+    std::vector<Uint8> m_finished;
+    std::vector<Pending> m_pending; // Cancelled or postponed ones are skipped lazily.
+    std::vector<Slot> m_slots;
+    std::vector<Uint32> m_free;
+    std::size_t m_parallel_threshold = 8'192u;
+    // The threshold follows the measured cost of a concurrent timer (moving
+    // average) and of a parallelFor on a pool of m_pool_size threads, of
+    // which m_pool_cores can run at once.
+    bool m_calibrating = true;
+    double m_timer_ns = 0.0, m_pool_ns = 0.0;
+    Uint32 m_pool_size = 0u, m_pool_cores = 0u;
+    std::vector<double> m_chunk_ns;
+    bool m_running = false;
+    bool m_running_concurrent = false; // No calls from the callbacks of concurrent timers.
+
+    // Set while the callbacks run, the loops own the layout of the timers.
+    struct Running {
+        bool & running;
+        explicit Running ( bool & running_ ) noexcept : running ( running_ ) {
+            running = true;
+        }
+        ~Running ( ) {
+            running = false;
+        }
+    };
 
-public:
+    static bool later ( const Pending & a_, const Pending & b_ ) noexcept {
+        return a_.start_time > b_.start_time;
+    }
 
-    inline void reserve ( const uint32_t r_ ) noexcept {
-        m_timers.reserve ( r_ );
+    void assertNotConcurrent ( ) const noexcept {
+        assert ( not m_running_concurrent and "the callback of a concurrent timer used the animator" );
     }
 
-    inline void clear ( ) noexcept {
-        m_timers.clear ( );
+    Uint32 acquire ( ) {
+        if ( m_free.empty ( ) ) {
+            m_slots.emplace_back ( );
+            return ( Uint32 ) ( m_slots.size ( ) - 1u );
+        }
+        const Uint32 slot = m_free.back ( );
+        m_free.pop_back ( );
+        return slot;
+    }
+
+    void release ( const Uint32 slot_ ) {
+        Slot & slot = m_slots [ slot_ ];
+        ++slot.generation;
+        slot.live = false;
+        m_free.push_back ( slot_ );
+    }
+
+    void wait ( const Uint32 slot_, const HrTimePoint start_time_ ) {
+        m_pending.push_back ( { start_time_, slot_, m_slots [ slot_ ].generation } );
+        std::push_heap ( std::begin ( m_pending ), std::end ( m_pending ), later );
+    }
+
+    void activate ( Entry && entry_ ) {
+        Slot & slot = m_slots [ entry_.slot ];
+        if ( entry_.concurrent ) {
+            slot.where = Where::concurrent;
+            slot.index = ( Uint32 ) m_concurrent.size ( );
+            m_concurrent.push_back ( std::move ( entry_ ) );
+        }
+        else {
+            slot.where = Where::serial;
+            slot.it = m_timers.insert ( std::move ( entry_ ) );
+        }
+    }
+
+    void eraseConcurrent ( const std::size_t i_ ) {
+        release ( m_concurrent [ i_ ].slot );
+        if ( i_ + 1u != m_concurrent.size ( ) ) {
+            m_concurrent [ i_ ] = std::move ( m_concurrent.back ( ) );
+            m_slots [ m_concurrent [ i_ ].slot ].index = ( Uint32 ) i_;
+        }
+        m_concurrent.pop_back ( );
     }
 
     template< typename ... Args >
-    inline void emplace ( Args ... args_ ) noexcept {
-        m_timers.emplace ( std::forward < Args > ( args_ ) ... );
+    Handle insert ( const bool concurrent_, Args && ... args_ ) {
+        assertNotConcurrent ( );
+        const Uint32 slot = acquire ( );
+        Entry entry { Timer ( std::forward < Args > ( args_ ) ... ), slot, concurrent_ };
+        m_slots [ slot ].live = true;
+        if ( m_running or entry.timer.startTime ( ) > Timer::Clock::now ( ) ) {
+            const HrTimePoint start_time = entry.timer.startTime ( );
+            m_slots [ slot ].where = Where::waiting;
+            m_slots [ slot ].it = m_waiting.insert ( std::move ( entry ) );
+            wait ( slot, start_time );
+        }
+        else {
+            activate ( std::move ( entry ) );
+        }
+        return { slot, m_slots [ slot ].generation };
+    }
+
+    void start ( const HrTimePoint now_ ) {
+        while ( m_pending.size ( ) and m_pending.front ( ).start_time <= now_ ) {
+            std::pop_heap ( std::begin ( m_pending ), std::end ( m_pending ), later );
+            const Pending pending = m_pending.back ( );
+            m_pending.pop_back ( );
+            Slot & slot = m_slots [ pending.slot ];
+            if ( not slot.live or slot.generation != pending.generation or Where::waiting != slot.where ) {
+                continue; // Cancelled.
+            }
+            if ( slot.it->timer.startTime ( ) > now_ ) {
+                wait ( pending.slot, slot.it->timer.startTime ( ) ); // Postponed by a pause.
+                continue;
+            }
+            const typename Timers::iterator it = slot.it;
+            activate ( std::move ( *it ) );
+            m_waiting.erase ( it );
+        }
     }
 
-    void run ( ) noexcept {
+    void runSerial ( const HrTimePoint now_ ) {
         typename Timers::iterator it = std::begin ( m_timers );
         while ( std::end ( m_timers ) != it ) {
-            if ( Timer::Status::finished == it->run ( ) ) {
+            const bool finished = not it->cancelled and not it->paused and Timer::Status::finished == it->timer.run ( now_ );
+            if ( finished or it->cancelled ) {
+                release ( it->slot );
                 it = m_timers.erase ( it );
             }
             else {
@@ -717,18 +1038,274 @@ public:
         }
     }
 
+    void runConcurrent ( const HrTimePoint now_ ) {
+        const Running running ( m_running_concurrent );
+        for ( std::size_t i = 0u; i < m_concurrent.size ( ); ) {
+            Entry & entry = m_concurrent [ i ];
+            const bool finished = not entry.cancelled and not entry.paused and Timer::Status::finished == entry.timer.run ( now_ );
+            if ( finished or entry.cancelled ) {
+                eraseConcurrent ( i ); // The last one moved to i, it has not run yet.
+            }
+            else {
+                ++i;
+            }
+        }
+    }
+
+    static double nanoseconds ( const HrTimePoint since_ ) noexcept {
+        return std::chrono::duration<double, std::nano> ( HrClock::now ( ) - since_ ).count ( );
+    }
+
+    // The fastest of a few empty parallelFors, once per pool size.
+    void measurePool ( ThreadPool & pool_ ) {
+        if ( pool_.size ( ) == m_pool_size ) {
+            return;
+        }
+        m_pool_size = pool_.size ( );
+        const Uint32 cores = std::thread::hardware_concurrency ( );
+        m_pool_cores = cores ? std::min ( cores, m_pool_size ) : m_pool_size;
+        m_pool_ns = std::numeric_limits<double>::max ( );
+        for ( int i = 0; i < 5; ++i ) {
+            const HrTimePoint start = HrClock::now ( );
+            pool_.parallelFor ( m_pool_size, [ ] ( const std::size_t ) { } );
+            m_pool_ns = std::min ( m_pool_ns, nanoseconds ( start ) );
+        }
+    }
+
+    // The pool pays off from n timers of cost c on p cores once
+    // pool + n c / p < n c, at least 2 chunks, never on a single core. The
+    // threshold only follows once it is off by more than a quarter, so that
+    // noise does not flip the path from one run to the next.
+    void calibrate ( const double ns_, const std::size_t n_ ) noexcept {
+        if ( not n_ ) {
+            return;
+        }
+        const double timer_ns = ns_ / ( double ) n_;
+        m_timer_ns = m_timer_ns > 0.0 ? 0.875 * m_timer_ns + 0.125 * timer_ns : timer_ns;
+        if ( m_calibrating and m_pool_cores < 2u ) {
+            m_parallel_threshold = std::numeric_limits<std::size_t>::max ( );
+        }
+        else if ( m_calibrating and m_timer_ns > 0.0 ) {
+            const double crossover = std::clamp ( m_pool_ns / ( m_timer_ns * ( 1.0 - 1.0 / ( double ) m_pool_cores ) ), 2.0 * ( double ) parallel_chunk_size, 1e9 );
+            const double threshold = ( double ) m_parallel_threshold;
+            if ( crossover < 0.75 * threshold or 1.25 * threshold < crossover ) {
+                m_parallel_threshold = ( std::size_t ) crossover;
+            }
+        }
+    }
+
+    Entry * find ( const Handle handle_ ) noexcept {
+        assertNotConcurrent ( );
+        if ( handle_.index < m_slots.size ( ) ) {
+            Slot & slot = m_slots [ handle_.index ];
+            if ( slot.live and slot.generation == handle_.generation ) {
+                Entry * const entry = Where::concurrent == slot.where ? &m_concurrent [ slot.index ] : &*slot.it;
+                return entry->cancelled ? nullptr : entry;
+            }
+        }
+        return nullptr;
+    }
+
+    const Entry * find ( const Handle handle_ ) const noexcept {
+        return const_cast<Animator *> ( this )->find ( handle_ );
+    }
+
+public:
+
+    inline void reserve ( const uint32_t r_ ) {
+        assertNotConcurrent ( );
+        m_timers.reserve ( r_ );
+        m_slots.reserve ( r_ );
+        m_free.reserve ( r_ );
+    }
+
+    inline void clear ( ) noexcept {
+        assertNotConcurrent ( );
+        if ( m_running ) {
+            for ( Entry & entry : m_timers ) {
+                entry.cancelled = true;
+            }
+            for ( Entry & entry : m_concurrent ) {
+                entry.cancelled = true;
+            }
+            for ( Entry & entry : m_waiting ) {
+                release ( entry.slot );
+            }
+            m_waiting.clear ( );
+            m_pending.clear ( );
+            return;
+        }
+        for ( Entry & entry : m_timers ) {
+            release ( entry.slot );
+        }
+        for ( Entry & entry : m_waiting ) {
+            release ( entry.slot );
+        }
+        for ( Entry & entry : m_concurrent ) {
+            release ( entry.slot );
+        }
+        m_timers.clear ( );
+        m_waiting.clear ( );
+        m_concurrent.clear ( );
+        m_pending.clear ( );
+    }
+
+    template< typename ... Args >
+    inline Handle emplace ( Args ... args_ ) {
+        return insert ( false, std::forward < Args > ( args_ ) ... );
+    }
+
+    // A timer whose callback may be called on a worker thread, concurrently
+    // with the callbacks of the other such timers. It must not call the
+    // animator: no emplace, cancel (not even of itself), pause or query.
+    template< typename ... Args >
+    inline Handle emplaceConcurrent ( Args ... args_ ) {
+        return insert ( true, std::forward < Args > ( args_ ) ... );
+    }
+
+    // Samples the clock once, all timers see the same time.
+    void run ( ) {
+        run ( Timer::Clock::now ( ) );
+    }
+
+    void run ( const HrTimePoint now_ ) {
+        assertNotConcurrent ( );
+        start ( now_ );
+        const Running running ( m_running );
+        runSerial ( now_ );
+        runConcurrent ( now_ );
+    }
+
+    // As run, with the concurrent timers in parallel on pool_.
+    void run ( ThreadPool & pool_ ) {
+        run ( Timer::Clock::now ( ), pool_ );
+    }
+
+    void run ( const HrTimePoint now_, ThreadPool & pool_ ) {
+        assertNotConcurrent ( );
+        start ( now_ );
+        const Running running ( m_running );
+        // The serial callbacks first, m_finished holds positions in
+        // m_concurrent from the parallel pass to the sweep.
+        runSerial ( now_ );
+        measurePool ( pool_ );
+        const std::size_t n = m_concurrent.size ( );
+        if ( n < m_parallel_threshold or pool_.size ( ) < 2u ) {
+            const HrTimePoint start = HrClock::now ( );
+            runConcurrent ( now_ );
+            calibrate ( nanoseconds ( start ), n );
+            return;
+        }
+        const std::size_t chunks = ( n + parallel_chunk_size - 1u ) / parallel_chunk_size;
+        m_finished.assign ( n, 0u );
+        m_chunk_ns.assign ( chunks, 0.0 );
+        {
+            // Set and reset on this thread, the workers only read it.
+            const Running running_concurrent ( m_running_concurrent );
+            pool_.parallelFor ( chunks, [ this, now_, n ] ( const std::size_t c_ ) {
+                const HrTimePoint start = HrClock::now ( );
+                for ( std::size_t i = c_ * parallel_chunk_size, end = std::min ( i + parallel_chunk_size, n ); i < end; ++i ) {
+                    Entry & entry = m_concurrent [ i ];
+                    m_finished [ i ] = not entry.cancelled and not entry.paused and Timer::Status::finished == entry.timer.run ( now_ );
+                }
+                m_chunk_ns [ c_ ] = nanoseconds ( start );
+            } );
+        }
+        calibrate ( std::accumulate ( std::begin ( m_chunk_ns ), std::end ( m_chunk_ns ), 0.0 ), n );
+        // Backwards, the last one that moves into an erased place is done.
+        for ( std::size_t i = n; i--; ) {
+            if ( m_finished [ i ] or m_concurrent [ i ].cancelled ) {
+                eraseConcurrent ( i );
+            }
+        }
+    }
+
+    // The number of concurrent timers from which run ( pool ) runs them in
+    // parallel, below it the pool costs more than it saves. It is calibrated
+    // by run ( pool ), from the time the concurrent timers take per timer and
+    // the time an empty parallelFor takes on the pool (8'192 until then).
+    std::size_t parallelThreshold ( ) const noexcept {
+        return m_parallel_threshold;
+    }
+
+    // A fixed threshold, that stops the calibration.
+    void setParallelThreshold ( const std::size_t threshold_ ) noexcept {
+        assertNotConcurrent ( );
+        m_parallel_threshold = threshold_;
+        m_calibrating = false;
+    }
+
+    void calibrateParallelThreshold ( ) noexcept {
+        m_calibrating = true;
+    }
+
+    // Removes the timer, it is not called again.
+    void cancel ( const Handle handle_ ) {
+        if ( Entry * const entry = find ( handle_ ) ) {
+            Slot & slot = m_slots [ handle_.index ];
+            if ( m_running and Where::waiting != slot.where ) {
+                entry->cancelled = true;
+                return;
+            }
+            switch ( slot.where ) {
+                case Where::waiting: m_waiting.erase ( slot.it ); break;
+                case Where::serial: m_timers.erase ( slot.it ); break;
+                case Where::concurrent: eraseConcurrent ( slot.index ); return;
+            }
+            release ( handle_.index );
+        }
+    }
+
+    // A paused timer is not called, on resume it continues where it paused.
+    void pause ( const Handle handle_ ) noexcept {
+        if ( Entry * const entry = find ( handle_ ); entry and not entry->paused ) {
+            entry->paused = true;
+            entry->paused_at = Timer::Clock::now ( );
+        }
+    }
+
+    void resume ( const Handle handle_ ) noexcept {
+        if ( Entry * const entry = find ( handle_ ); entry and entry->paused ) {
+            entry->paused = false;
+            entry->timer.postpone ( Timer::Clock::now ( ) - entry->paused_at );
+        }
+    }
+
+    // Tweens from the current value to end_, see Timer::retarget.
+    template<typename Value>
+    void retarget ( const Handle handle_, const Value & end_ ) noexcept {
+        if ( Entry * const entry = find ( handle_ ) ) {
+            entry->timer.retarget ( end_, entry->paused ? entry->paused_at : Timer::Clock::now ( ) );
+        }
+    }
+
+    // 0...1, or empty if the timer finished or was cancelled.
+    std::optional<float> progress ( const Handle handle_ ) const noexcept {
+        if ( const Entry * const entry = find ( handle_ ) ) {
+            return entry->timer.progress ( entry->paused ? entry->paused_at : Timer::Clock::now ( ) );
+        }
+        return { };
+    }
+
+    bool alive ( const Handle handle_ ) const noexcept {
+        return nullptr != find ( handle_ );
+    }
+
     inline uint32_t size ( ) const noexcept {
-        return ( uint32_t ) m_timers.size ( );
+        return ( uint32_t ) ( m_timers.size ( ) + m_waiting.size ( ) + m_concurrent.size ( ) );
+    }
+
+    // The timers that are past their delay.
+    inline uint32_t active ( ) const noexcept {
+        return ( uint32_t ) ( m_timers.size ( ) + m_concurrent.size ( ) );
     }
 
     inline bool empty ( ) const noexcept {
-        return m_timers.empty ( );
+        return m_timers.empty ( ) and m_waiting.empty ( ) and m_concurrent.empty ( );
     }
 };
 
 using CallbackAnimator = Animator<CallbackTimer>;
-#ifdef DELEGATE_IMP
 using DelegateAnimator = Animator<DelegateTimer>;
-#endif
 
 }
@@ -0,0 +1,262 @@
+
+// MIT License
+//
+// Copyright (c) 2019 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Extensions.hpp"
+#include "Animation.hpp"
+#include "Delegate.hpp"
+
+namespace sf {
+
+// An animator for many tweens of a few easings. The tweens are grouped by
+// easing (a compile time list of the easing types) into structure-of-arrays,
+// each run evaluates the progress and the easing of a whole group in one pass
+// (the easing is inlined, so the simple ones vectorize) and then writes the
+// values to bound floats or calls the callbacks. Finished tweens are removed
+// by swapping in the last one, the order of the tweens in a group changes.
+//
+//     sf::BatchAnimator<sf::easing::linearEasing, sf::easing::quadraticOutEasing> animator;
+//     animator.emplace ( sf::easing::quadraticOut, &sprite_alpha, 0.0f, 255.0f, std::chrono::milliseconds { 500 } );
+//     animator.run ( ); // Every frame.
+//
+// The clock is HrClock, or f.e. a ManualClock for BasicBatchAnimator.
+template<typename Clock, typename... Easings>
+class BasicBatchAnimator {
+
+    public:
+
+    using Callback = Delegate<void ( const float )>;
+
+    BasicBatchAnimator ( ) noexcept : m_epoch ( Clock::now ( ) ) { }
+
+    // Writes the eased value to *target_ every run, the last one is end_. A
+    // tween without duration or delay writes end_ at once and is not kept.
+    template<typename Easing>
+    void emplace ( const Easing &, float * target_, const float start_, const float end_, const FloatDuration duration_, const std::chrono::milliseconds delay_ = std::chrono::milliseconds { 0 } ) {
+        push ( group<Easing> ( ).targets, target_, start_, end_, duration_, delay_ );
+    }
+
+    // Calls callback_ with the eased value every run, the last one is end_. A
+    // tween without duration or delay calls it with end_ at once.
+    template<typename Easing>
+    void emplace ( const Easing &, Callback callback_, const float start_, const float end_, const FloatDuration duration_, const std::chrono::milliseconds delay_ = std::chrono::milliseconds { 0 } ) {
+        push ( group<Easing> ( ).callbacks, std::move ( callback_ ), start_, end_, duration_, delay_ );
+    }
+
+    // Samples the clock once, all tweens see the same time.
+    void run ( ) {
+        run ( Clock::now ( ) );
+    }
+
+    void run ( const HrTimePoint now_ ) {
+        rebase ( now_ );
+        const float time = std::chrono::duration<float> ( now_ - m_epoch ).count ( );
+        std::apply ( [ time ] ( auto &... groups_ ) { ( groups_.run ( time ), ... ); }, m_groups );
+    }
+
+    void reserve ( const std::size_t size_ ) {
+        std::apply ( [ size_ ] ( auto &... groups_ ) { ( groups_.reserve ( size_ ), ... ); }, m_groups );
+    }
+
+    void clear ( ) noexcept {
+        std::apply ( [ ] ( auto &... groups_ ) { ( groups_.clear ( ), ... ); }, m_groups );
+    }
+
+    std::size_t size ( ) const noexcept {
+        return std::apply ( [ ] ( const auto &... groups_ ) { return ( std::size_t { 0 } + ... + groups_.size ( ) ); }, m_groups );
+    }
+
+    bool empty ( ) const noexcept {
+        return 0u == size ( );
+    }
+
+    private:
+
+    // The tweens of one easing that write to the same kind of sink, a float
+    // pointer or a callback.
+    template<typename Sink>
+    struct Tweens {
+        AlignedVector<float> start_time; // Seconds since the epoch.
+        AlignedVector<float> inverse_duration, start, end, value; // An inverse duration of 0 jumps to the end at the start time.
+        std::vector<Sink> sink;
+
+        void push ( Sink sink_, const float start_time_, const float duration_, const float start_, const float end_ ) {
+            start_time.push_back ( start_time_ );
+            inverse_duration.push_back ( duration_ > 0.0f ? 1.0f / duration_ : 0.0f );
+            start.push_back ( start_ );
+            end.push_back ( end_ );
+            value.push_back ( start_ );
+            sink.push_back ( std::move ( sink_ ) );
+        }
+
+        void erase ( const std::size_t i_ ) noexcept {
+            const std::size_t last = sink.size ( ) - 1u;
+            start_time [ i_ ] = start_time [ last ];
+            inverse_duration [ i_ ] = inverse_duration [ last ];
+            start [ i_ ] = start [ last ];
+            end [ i_ ] = end [ last ];
+            value [ i_ ] = value [ last ];
+            sink [ i_ ] = std::move ( sink [ last ] );
+            start_time.pop_back ( );
+            inverse_duration.pop_back ( );
+            start.pop_back ( );
+            end.pop_back ( );
+            value.pop_back ( );
+            sink.pop_back ( );
+        }
+
+        template<typename Easing>
+        void run ( const float time_ ) {
+            const std::size_t n = sink.size ( );
+            const float * const s = start_time.data ( ), * const d = inverse_duration.data ( ), * const a = start.data ( ), * const b = end.data ( );
+            float * const v = value.data ( );
+            std::size_t finished = 0u;
+            for ( std::size_t i = 0; i < n; ++i ) {
+                const float progress = Tweens::progress ( time_, s [ i ], d [ i ] );
+                const float eased = Easing::template run<float> ( std::clamp ( progress, 0.0f, 1.0f ), a [ i ], b [ i ] );
+                v [ i ] = progress < 1.0f ? eased : b [ i ];
+                finished += progress >= 1.0f;
+            }
+            // A callback may emplace into this group (reallocating the arrays)
+            // or clear the animator, so index again for every tween and call
+            // a copy of the sink. Tweens added here first run next time.
+            for ( std::size_t i = 0; i < n and i < sink.size ( ); ++i ) {
+                if ( start_time [ i ] <= time_ ) {
+                    dispatch ( Sink ( sink [ i ] ), value [ i ] );
+                }
+            }
+            for ( std::size_t i = std::min ( n, sink.size ( ) ); finished and i--; ) {
+                if ( progress ( time_, start_time [ i ], inverse_duration [ i ] ) >= 1.0f ) {
+                    erase ( i );
+                    --finished;
+                }
+            }
+        }
+
+        // Without infinities (no 0 * inf at the start time), -ffast-math assumes there are none.
+        static float progress ( const float time_, const float start_time_, const float inverse_duration_ ) noexcept {
+            return inverse_duration_ > 0.0f ? ( time_ - start_time_ ) * inverse_duration_ : time_ >= start_time_ ? 1.0f : 0.0f;
+        }
+
+        static void dispatch ( float * target_, const float value_ ) noexcept {
+            *target_ = value_;
+        }
+        static void dispatch ( const Callback & callback_, const float value_ ) {
+            callback_ ( value_ );
+        }
+
+        void reserve ( const std::size_t size_ ) {
+            start_time.reserve ( size_ );
+            inverse_duration.reserve ( size_ );
+            start.reserve ( size_ );
+            end.reserve ( size_ );
+            value.reserve ( size_ );
+            sink.reserve ( size_ );
+        }
+
+        void clear ( ) noexcept {
+            start_time.clear ( );
+            inverse_duration.clear ( );
+            start.clear ( );
+            end.clear ( );
+            value.clear ( );
+            sink.clear ( );
+        }
+
+        void rebase ( const float offset_ ) noexcept {
+            for ( float & s : start_time ) {
+                s -= offset_;
+            }
+        }
+    };
+
+    template<typename Easing>
+    struct Group {
+        Tweens<float *> targets;
+        Tweens<Callback> callbacks;
+
+        void run ( const float time_ ) {
+            targets.template run<Easing> ( time_ );
+            callbacks.template run<Easing> ( time_ );
+        }
+        void reserve ( const std::size_t size_ ) {
+            targets.reserve ( size_ );
+            callbacks.reserve ( size_ );
+        }
+        void clear ( ) noexcept {
+            targets.clear ( );
+            callbacks.clear ( );
+        }
+        std::size_t size ( ) const noexcept {
+            return targets.sink.size ( ) + callbacks.sink.size ( );
+        }
+        void rebase ( const float offset_ ) noexcept {
+            targets.rebase ( offset_ );
+            callbacks.rebase ( offset_ );
+        }
+    };
+
+    template<typename Easing>
+    Group<Easing> & group ( ) noexcept {
+        static_assert ( ( std::is_same<Easing, Easings>::value or ... ), "the easing is not one of the easings of this animator" );
+        return std::get<Group<Easing>> ( m_groups );
+    }
+
+    template<typename Sink>
+    void push ( Tweens<Sink> & tweens_, Sink sink_, const float start_, const float end_, const FloatDuration duration_, const std::chrono::milliseconds delay_ ) {
+        if ( duration_.count ( ) <= 0.0f and delay_.count ( ) <= 0 ) {
+            Tweens<Sink>::dispatch ( sink_, end_ );
+            return;
+        }
+        tweens_.push ( std::move ( sink_ ), startTime ( delay_ ), duration_.count ( ), start_, end_ );
+    }
+
+    float startTime ( const std::chrono::milliseconds delay_ ) const noexcept {
+        return std::chrono::duration<float> ( Clock::now ( ) + delay_ - m_epoch ).count ( );
+    }
+
+    // The times are floats relative to the epoch, move the epoch up by an hour
+    // (exact in a float) every hour to keep them (sub) millisecond accurate.
+    void rebase ( const HrTimePoint now_ ) noexcept {
+        while ( now_ - m_epoch > std::chrono::hours { 2 } ) {
+            m_epoch += std::chrono::hours { 1 };
+            std::apply ( [ ] ( auto &... groups_ ) { ( groups_.rebase ( 3'600.0f ), ... ); }, m_groups );
+        }
+    }
+
+    HrTimePoint m_epoch;
+    std::tuple<Group<Easings>...> m_groups;
+};
+
+template<typename... Easings>
+using BatchAnimator = BasicBatchAnimator<HrClock, Easings...>;
+
+}
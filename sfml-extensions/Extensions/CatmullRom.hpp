@@ -24,6 +24,7 @@
 #pragma once
 
 #include <cmath>
+#include <span>
 #include <vector>
 
 #include <boost/container/deque.hpp>
@@ -32,6 +33,10 @@
 #include "Extensions.hpp"
 
 
+namespace sf {
+class ThreadPool;
+}
+
 namespace sf::CatmullRom {
 
     using Points = boost::container::deque<Point>;
@@ -53,6 +58,50 @@ namespace sf::CatmullRom {
         return return_value;
     }
 
+    struct CubicPoly {
+
+        float c0, c1, c2, c3;
+
+        float evaluate ( const float t_ ) const noexcept {
+
+            const float t2 = t_ * t_;
+
+            return c0 + c1 * t_ + c2 * t2 + c3 * t2 * t_;
+        }
+    };
+
+    // A segment of the curve, t in [ 0, 1 ]...
+    struct CubicPolyXY {
+
+        CubicPoly x, y;
+
+        Vector2f evaluate ( const float t_ ) const noexcept {
+
+            const float t2 = t_ * t_, t3 = t2 * t_;
+
+            return Vector2f { x.c0 + x.c1 * t_ + x.c2 * t2 + x.c3 * t3, y.c0 + y.c1 * t_ + y.c2 * t2 + y.c3 * t3 };
+        }
+
+        Vector2f derivative ( const float t_ ) const noexcept {
+
+            return Vector2f { x.c1 + ( 2.0f * x.c2 + 3.0f * x.c3 * t_ ) * t_, y.c1 + ( 2.0f * y.c2 + 3.0f * y.c3 * t_ ) * t_ };
+        }
+
+        // The length of the derivative, ds / dt.
+        float speed ( const float t_ ) const noexcept {
+
+            const Vector2f d = derivative ( t_ );
+
+            return std::sqrtf ( d.x * d.x + d.y * d.y );
+        }
+    };
+
+    // Samples poly_ at t = first_ + i * step_ for i in [ 0, n_ ), in Horner form, 8 at a
+    // time where the cpu has avx2 (4 with sse2), into x_ [ i ] and y_ [ i ]...
+    void evaluate ( const CubicPolyXY & poly_, const float first_, const float step_, float * x_, float * y_, const std::size_t n_ ) noexcept;
+    // ... or into out_ [ i ].
+    void evaluate ( const CubicPolyXY & poly_, const float first_, const float step_, Point * out_, const std::size_t n_ ) noexcept;
+
     // CoordinatesVector catmullRom0 ( const Points &points_, const int number_of_points_per_interval_ );
 
     // Calculate Catmull Rom for a chain of points and return the combined curve. The
@@ -60,9 +109,121 @@ namespace sf::CatmullRom {
     // last point, respectively...
     CoordinatesVector catmullRom ( const Points & points_, const Int32 number_of_points_per_interval_ ) noexcept;
 
+    // As above, appending the curve to return_value_, which does not allocate once it
+    // has the capacity. Reentrant...
+    void catmullRom ( CoordinatesVector & return_value_, const Points & points_, const Int32 number_of_points_per_interval_ ) noexcept;
+
+    // The segments per task of the parallel overload.
+    constexpr std::size_t parallel_chunk_size = 64ULL;
+
+    // As above, the segments in parallel on pool_, parallel_chunk_size at a time.
+    void catmullRom ( CoordinatesVector & return_value_, const Points & points_, const Int32 number_of_points_per_interval_, ThreadPool & pool_ );
+
+    // The number of points catmullRom ( points_, number_of_points_per_interval_ ) returns.
+    std::size_t estimateSize ( const Points & points_, const Int32 number_of_points_per_interval_ ) noexcept;
+
+    // How the distance overload spaces the points...
+    enum class Spacing : Int32 {
+
+        // Equally spaced along the curve: the arc length between consecutive points
+        // is distance_ within spacing_tolerance * distance_ (per segment), the
+        // straight distance is that, less in bends. Found with an arc length table
+        // per segment...
+        arcLength,
+
+        // The straight distance between consecutive points is distance_ (at least),
+        // found by stepping along the curve. Slow, kept for comparison...
+        chordSearch
+    };
+
+    // The relative tolerance of Spacing::arcLength.
+    constexpr float spacing_tolerance = 1e-3f;
+
     // Calculate Catmull Rom for a chain of points and return the combined curve. The
     // chains' first and last point are extrapolated from the second and 1-before-
     // last point, respectively. The returned points are at a distance of distance_
-    // (at least) away from each other... 	Requires 3 points or more...
-    CoordinatesVector catmullRom ( const Points & points_, float distance_ ) noexcept;
+    // away from each other, as spacing_ specifies... 	Requires 2 points or more...
+    CoordinatesVector catmullRom ( const Points & points_, const float distance_, const Spacing spacing_ = Spacing::arcLength ) noexcept;
+
+    // As above, appending the curve to return_value_, which does not allocate once it
+    // has the capacity. Reentrant, so workers can each fill their own buffer...
+    void catmullRom ( CoordinatesVector & return_value_, const Points & points_, float distance_, const Spacing spacing_ = Spacing::arcLength ) noexcept;
+
+    // The number of points catmullRom ( points_, distance_ ) returns, estimated from the
+    // length of the polygon, for reserving a buffer. Usually an over estimate...
+    std::size_t estimateSize ( const Points & points_, const float distance_ ) noexcept;
+
+    // The depth to which catmullRomAdaptive halves a segment, 2^16 pieces at most.
+    constexpr Int32 max_subdivision_depth = 16;
+
+    // Calculate Catmull Rom for a chain of points and return the combined curve as a
+    // polyline within max_deviation_ (f.e. in pixels) of it, from the first to the last
+    // point. A segment is halved until the Bezier control points of each piece are that
+    // close to its chord, so straight stretches get few points and tight bends many...
+    // Requires 2 points or more...
+    CoordinatesVector catmullRomAdaptive ( const Points & points_, const float max_deviation_ ) noexcept;
+
+    // As above, appending the curve to return_value_.
+    void catmullRomAdaptive ( CoordinatesVector & return_value_, const Points & points_, const float max_deviation_ ) noexcept;
+
+    // A Catmull Rom curve through a rolling window of at most capacity_ points (f.e. a
+    // mouse trail or a projectile path), sampled like catmullRom ( points_,
+    // number_of_points_per_interval_ ) would with the points in the window. The segments
+    // and their samples are cached in ring buffers, push_back and pop_front recompute
+    // only the 2 segments they change, so a point costs the same however long the
+    // trail is. Does not allocate after construction...
+    class IncrementalSpline {
+        public:
+        IncrementalSpline ( const std::size_t capacity_, const Int32 number_of_points_per_interval_ );
+
+        // Appends point_, drops the oldest point first if full.
+        void push_back ( const Point & point_ ) noexcept;
+        void pop_front ( ) noexcept;
+        void clear ( ) noexcept;
+
+        // The points.
+        std::size_t size ( ) const noexcept {
+            return m_size;
+        }
+        std::size_t capacity ( ) const noexcept {
+            return m_capacity;
+        }
+        bool empty ( ) const noexcept {
+            return not m_size;
+        }
+        const Point & operator [ ] ( const std::size_t i_ ) const noexcept {
+            return m_points [ ( m_head + i_ ) & m_mask ];
+        }
+
+        // The segments, between point i_ and i_ + 1.
+        std::size_t segments ( ) const noexcept {
+            return m_size ? m_size - 1ULL : 0ULL;
+        }
+        const CubicPolyXY & segment ( const std::size_t i_ ) const noexcept {
+            return m_segments [ ( m_head + i_ ) & m_mask ];
+        }
+
+        // The curve, number_of_points_per_interval_ samples per segment, in order: sample
+        // ( i_ ), or the 2 contiguous parts of the ring buffer, first ( ) and then second ( ).
+        std::size_t samples ( ) const noexcept {
+            return segments ( ) * m_per_segment;
+        }
+        const Point & sample ( const std::size_t i_ ) const noexcept {
+            return m_samples [ ( m_head * m_per_segment + i_ ) % m_samples.size ( ) ];
+        }
+        std::span<const Point> first ( ) const noexcept;
+        std::span<const Point> second ( ) const noexcept;
+
+        private:
+        // Point i_, extrapolated before the first and after the last.
+        Point point ( const std::ptrdiff_t i_ ) const noexcept;
+        // Recomputes and samples segment i_.
+        void update ( const std::size_t i_ ) noexcept;
+
+        std::vector<Point> m_points;
+        std::vector<CubicPolyXY> m_segments; // In the slot of their first point.
+        std::vector<Point> m_samples; // m_per_segment per segment slot.
+        // The ring buffers hold a power of 2 slots, m_mask indexes them.
+        std::size_t m_capacity, m_mask, m_head = 0ULL, m_size = 0ULL, m_per_segment;
+    };
 }
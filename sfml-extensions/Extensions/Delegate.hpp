@@ -0,0 +1,165 @@
+
+// MIT License
+//
+// Copyright (c) 2019 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sf {
+
+// A callable wrapper like std::function, which never allocates: the callable
+// lives in an inline buffer of Capacity bytes, one that doesn't fit (or can
+// throw on a move) doesn't compile. Trivially copyable callables (lambdas
+// capturing pointers, std::bind of a member function and this) are copied
+// with a memcpy and need no destructor.
+template<typename Signature, std::size_t Capacity = 32u>
+class Delegate;
+
+template<typename R, typename ... Args, std::size_t Capacity>
+class Delegate<R ( Args ... ), Capacity> {
+
+    enum class Operation { Copy, Move, Destroy };
+
+    using Invoke = R ( * ) ( void *, Args ... );
+    using Manage = void ( * ) ( const Operation, void *, void * );
+
+    public:
+
+    static constexpr std::size_t capacity = Capacity;
+
+    template<typename F>
+    static constexpr bool fits = sizeof ( F ) <= Capacity and alignof ( F ) <= alignof ( std::max_align_t ) and std::is_nothrow_move_constructible<F>::value;
+
+    Delegate ( ) noexcept = default;
+    Delegate ( std::nullptr_t ) noexcept { }
+
+    template<typename F, typename Callable = std::decay_t<F>, typename = std::enable_if_t<not std::is_same<Callable, Delegate>::value and std::is_invocable_r<R, Callable &, Args ...>::value>>
+    Delegate ( F && f_ ) noexcept ( std::is_nothrow_constructible<Callable, F>::value ) {
+        static_assert ( fits<Callable>, "the callable doesn't fit the inline buffer of the delegate" );
+        new ( m_storage ) Callable ( std::forward<F> ( f_ ) );
+        m_invoke = &invoke<Callable>;
+        m_manage = std::is_trivially_copyable<Callable>::value and std::is_trivially_destructible<Callable>::value ? nullptr : &manage<Callable>;
+    }
+
+    Delegate ( const Delegate & other_ ) {
+        copy ( other_ );
+    }
+
+    Delegate ( Delegate && other_ ) noexcept {
+        move ( other_ );
+    }
+
+    ~Delegate ( ) {
+        reset ( );
+    }
+
+    Delegate & operator = ( const Delegate & other_ ) {
+        if ( this != &other_ ) {
+            reset ( );
+            copy ( other_ );
+        }
+        return *this;
+    }
+
+    Delegate & operator = ( Delegate && other_ ) noexcept {
+        if ( this != &other_ ) {
+            reset ( );
+            move ( other_ );
+        }
+        return *this;
+    }
+
+    Delegate & operator = ( std::nullptr_t ) noexcept {
+        reset ( );
+        return *this;
+    }
+
+    R operator ( ) ( Args ... args_ ) const {
+        return m_invoke ( const_cast<unsigned char *> ( m_storage ), std::forward<Args> ( args_ ) ... );
+    }
+
+    explicit operator bool ( ) const noexcept {
+        return nullptr != m_invoke;
+    }
+
+    void reset ( ) noexcept {
+        if ( m_manage ) {
+            m_manage ( Operation::Destroy, m_storage, nullptr );
+        }
+        m_invoke = nullptr;
+        m_manage = nullptr;
+    }
+
+    private:
+
+    template<typename F>
+    static R invoke ( void * storage_, Args ... args_ ) {
+        return ( *static_cast<F *> ( storage_ ) ) ( std::forward<Args> ( args_ ) ... );
+    }
+
+    template<typename F>
+    static void manage ( const Operation operation_, void * destination_, void * source_ ) {
+        switch ( operation_ ) {
+            case Operation::Copy: new ( destination_ ) F ( *static_cast<const F *> ( source_ ) ); break;
+            case Operation::Move:
+                new ( destination_ ) F ( std::move ( *static_cast<F *> ( source_ ) ) );
+                static_cast<F *> ( source_ )->~F ( );
+                break;
+            case Operation::Destroy: static_cast<F *> ( destination_ )->~F ( ); break;
+        }
+    }
+
+    void copy ( const Delegate & other_ ) {
+        if ( other_.m_manage ) {
+            other_.m_manage ( Operation::Copy, m_storage, const_cast<unsigned char *> ( other_.m_storage ) );
+        }
+        else {
+            std::memcpy ( m_storage, other_.m_storage, Capacity );
+        }
+        m_invoke = other_.m_invoke;
+        m_manage = other_.m_manage;
+    }
+
+    void move ( Delegate & other_ ) noexcept {
+        if ( other_.m_manage ) {
+            other_.m_manage ( Operation::Move, m_storage, other_.m_storage );
+        }
+        else {
+            std::memcpy ( m_storage, other_.m_storage, Capacity );
+        }
+        m_invoke = other_.m_invoke;
+        m_manage = other_.m_manage;
+        other_.m_invoke = nullptr;
+        other_.m_manage = nullptr;
+    }
+
+    alignas ( std::max_align_t ) unsigned char m_storage [ Capacity ] = { };
+    Invoke m_invoke = nullptr;
+    Manage m_manage = nullptr;
+};
+
+}
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#if defined ( _WIN32 )
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
 #endif
@@ -31,6 +32,7 @@
 #include <Dwmapi.h>
 #include <Mmsystem.h>
 #include <intrin.h>
+#endif
 
 #include <cassert>
 #include <ctime>
@@ -40,6 +42,7 @@
 #include <chrono>
 #include <functional>
 #include <iomanip>
+#include <new>
 #include <numeric>
 #include <optional>
 #include <ostream>
@@ -134,6 +137,36 @@ struct Factory {
 };
 
 
+// Allocator returning Alignment-aligned storage, for arrays that are walked
+// with vector loads or split between threads (the default is a cache line).
+template<typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator ( ) noexcept = default;
+    template<typename U>
+    AlignedAllocator ( const AlignedAllocator<U, Alignment> & ) noexcept { }
+
+    [[ nodiscard ]] T * allocate ( const std::size_t n_ ) {
+        return static_cast<T *> ( ::operator new ( n_ * sizeof ( T ), std::align_val_t { Alignment } ) );
+    }
+    void deallocate ( T * p_, const std::size_t ) noexcept {
+        ::operator delete ( p_, std::align_val_t { Alignment } );
+    }
+
+    template<typename U>
+    bool operator == ( const AlignedAllocator<U, Alignment> & ) const noexcept { return true; }
+    template<typename U>
+    bool operator != ( const AlignedAllocator<U, Alignment> & ) const noexcept { return false; }
+};
+
+template<typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+
 // Dealing with radians.
 
 constexpr float pi = 3.1415926535897932384626433832795;
@@ -162,6 +195,15 @@ void sleepForMicroseconds ( const Int32 microseconds_ ) noexcept;
 
 std::string systemTime ( ) noexcept;
 
+// Widest vector instruction set used by the batch kernels, from narrow to wide.
+enum class SimdLevel : Int32 { Scalar, SSE2, AVX2 };
+// The widest level this cpu (and os) supports, detected once.
+SimdLevel cpuSimdLevel ( ) noexcept;
+
+// The window, timer resolution, resource and pacing functions below wrap the
+// win32 api, the rest of the library (and the benchmarks) builds elsewhere too.
+#if defined ( _WIN32 )
+
 inline void timeBeginPeriod ( ) noexcept {
     ::timeBeginPeriod ( 1 );
 }
@@ -181,6 +223,9 @@ void moveWindowTop ( RenderWindowRef rw_ ) noexcept;
 void moveWindowBottom (RenderWindowRef rw_) noexcept;
 void moveWindowAfter (RenderWindowRef rw_, RenderWindowRef after_rw_ ) noexcept;
 Int32 getScreenRefreshRate ( ) noexcept;
+
+#endif
+
 ScreenSizeType getScreenSizeType ( ) noexcept;
 
 struct SquareShape : RectangleShape {
@@ -255,6 +300,8 @@ S & operator << ( S & out_, const Vector2i & v_ ) {
 }
 
 
+#if defined ( _WIN32 )
+
 // Loading resources.
 
 // Loads T (Image, Texture, Font, SoundBuffer)
@@ -289,6 +336,8 @@ std::string loadFromResource ( const Int32 name );
 void loadFromResource ( Shader &shader_, const Shader::Type type_, const Int32 name_ );
 void loadFromResource ( Shader &shader_, const Int32 vertex_name_, const Int32 fragment_name_ );
 
+#endif
+
 
 // Vector2 casting.
 
@@ -346,7 +395,7 @@ inline float max ( const T a, const T b, const T c ) noexcept { return std::max
 
 // Pacer
 
-
+#if defined ( _WIN32 )
 
 struct Pacer {
 
@@ -402,6 +451,8 @@ struct Pacer {
     }
 };
 
+#endif
+
 
 }
 
@@ -43,12 +43,16 @@ struct LZ4Dictionary {
     LZ4Dictionary ( ) noexcept              = default;
     LZ4Dictionary ( LZ4Dictionary const & ) = delete;
     LZ4Dictionary ( LZ4Dictionary && other_ ) noexcept;
+#if defined( _WIN32 )
     // Load from resource.
     LZ4Dictionary ( int name_ );
+#endif
     ~LZ4Dictionary ( );
     [[maybe_unused]] LZ4Dictionary const & operator= ( LZ4Dictionary const & ) = delete;
     [[maybe_unused]] LZ4Dictionary const & operator= ( LZ4Dictionary && other_ ) noexcept;
+#if defined( _WIN32 )
     void loadFromResource ( int name_ );
+#endif
 
     private:
     friend class LZ4OStreamBuf;
@@ -0,0 +1,306 @@
+
+// MIT License
+//
+// Copyright (c) 2019 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <utility>
+
+#include <SFML/Graphics.hpp>
+
+#include "Extensions.hpp"
+#include "ParticleSystem.hpp"
+#include "ThreadPool.hpp"
+
+namespace sf {
+
+// The state of 8 particles as the affectors see it. The update loads a block,
+// decrements the lifetime and writes the default color, runs the affectors,
+// integrates the position and stores the block, all in one pass.
+struct ParticleBlock {
+    static constexpr std::size_t lanes = ParticleArrays::lanes;
+
+    float position_x [ lanes ], position_y [ lanes ], velocity_x [ lanes ], velocity_y [ lanes ];
+    float lifetime [ lanes ];         // Seconds left.
+    float inverse_lifetime [ lanes ]; // 1 / lifetime at spawn.
+    float age [ lanes ];              // Fraction of the lifetime passed, in [ 0, 1 ].
+    float scale [ lanes ], rotation [ lanes ];
+    Uint32 color [ lanes ];           // Packed sf::Color, red in the low byte.
+};
+
+
+// An affector is a callable ( ParticleBlock &, const float dt ) that loops
+// over the lanes, the loops are simple enough for the compiler to vectorize.
+
+// Constant acceleration, pixels per second squared.
+struct GravityAffector {
+    Vector2f acceleration { 0.0f, 98.1f };
+
+    void operator ( ) ( ParticleBlock & block_, const float dt_ ) const noexcept {
+        const float ax = acceleration.x * dt_, ay = acceleration.y * dt_;
+        for ( std::size_t j = 0; j < ParticleBlock::lanes; ++j ) {
+            block_.velocity_x [ j ] += ax;
+            block_.velocity_y [ j ] += ay;
+        }
+    }
+};
+
+// Linear drag, a particle loses coefficient * dt of its velocity per step.
+struct DragAffector {
+    float coefficient = 1.0f;
+
+    void operator ( ) ( ParticleBlock & block_, const float dt_ ) const noexcept {
+        const float keep = std::max ( 1.0f - coefficient * dt_, 0.0f );
+        for ( std::size_t j = 0; j < ParticleBlock::lanes; ++j ) {
+            block_.velocity_x [ j ] *= keep;
+            block_.velocity_y [ j ] *= keep;
+        }
+    }
+};
+
+// Pulls towards position with strength / distance^2 (repels if negative). The
+// softening radius keeps the force finite near the center.
+struct AttractorAffector {
+    Vector2f position;
+    float strength = 100'000.0f, softening = 10.0f;
+
+    void operator ( ) ( ParticleBlock & block_, const float dt_ ) const noexcept {
+        const float s = strength * dt_, s2 = softening * softening;
+        for ( std::size_t j = 0; j < ParticleBlock::lanes; ++j ) {
+            const float dx = position.x - block_.position_x [ j ], dy = position.y - block_.position_y [ j ];
+            const float inverse = 1.0f / std::sqrt ( dx * dx + dy * dy + s2 );
+            const float a = s * inverse * inverse * inverse;
+            block_.velocity_x [ j ] += dx * a;
+            block_.velocity_y [ j ] += dy * a;
+        }
+    }
+};
+
+// Color over life, from begin at spawn to end at death, alpha included.
+// Replaces the color (and lifetime fade) the update was called with.
+struct ColorGradientAffector {
+    Color begin = Color::White, end = Color::Transparent;
+
+    void operator ( ) ( ParticleBlock & block_, const float ) const noexcept {
+        const float r = begin.r, g = begin.g, b = begin.b, a = begin.a;
+        const float dr = end.r - r, dg = end.g - g, db = end.b - b, da = end.a - a;
+        for ( std::size_t j = 0; j < ParticleBlock::lanes; ++j ) {
+            const float t = block_.age [ j ];
+            block_.color [ j ] = ( Uint32 ) ( ( Int32 ) ( r + dr * t ) | ( Int32 ) ( g + dg * t ) << 8 | ( Int32 ) ( b + db * t ) << 16 | ( Int32 ) ( a + da * t ) << 24 );
+        }
+    }
+};
+
+// Size over life, from begin at spawn to end at death. Only quads have a
+// size, see ParticleSystemSoA::setQuads.
+struct ScaleAffector {
+    float begin = 1.0f, end = 0.0f;
+
+    void operator ( ) ( ParticleBlock & block_, const float ) const noexcept {
+        for ( std::size_t j = 0; j < ParticleBlock::lanes; ++j ) {
+            block_.scale [ j ] = begin + ( end - begin ) * block_.age [ j ];
+        }
+    }
+};
+
+// Turns the particles at speed radians per second. Only rotated quads show
+// it.
+struct SpinAffector {
+    float speed = pi;
+
+    void operator ( ) ( ParticleBlock & block_, const float dt_ ) const noexcept {
+        const float angle = speed * dt_;
+        for ( std::size_t j = 0; j < ParticleBlock::lanes; ++j ) {
+            block_.rotation [ j ] += angle;
+        }
+    }
+};
+
+
+// Affectors composed at compile time, applied in order to every block. F.e.:
+//
+//     sf::AffectorPipeline pipeline { sf::GravityAffector { }, sf::DragAffector { 0.5f } };
+//     particles.update ( elapsed, sf::Color::White, pipeline );
+template<typename... Affectors>
+class AffectorPipeline {
+    public:
+    constexpr AffectorPipeline ( Affectors... affectors_ ) : m_affectors ( std::move ( affectors_ )... ) { }
+
+    void operator ( ) ( ParticleBlock & block_, const float dt_ ) const noexcept {
+        std::apply ( [ & ] ( const Affectors &... affectors_ ) { ( affectors_ ( block_, dt_ ), ... ); }, m_affectors );
+    }
+
+    // The I-th affector, to change f.e. an attractor position between frames.
+    template<std::size_t I>
+    auto & get ( ) noexcept {
+        return std::get<I> ( m_affectors );
+    }
+    template<std::size_t I>
+    const auto & get ( ) const noexcept {
+        return std::get<I> ( m_affectors );
+    }
+
+    private:
+    std::tuple<Affectors...> m_affectors;
+};
+
+
+namespace detail {
+
+template<typename Pipeline>
+inline void affectBlock ( ParticleBlock & block_, const ParticleStep & step_, const Pipeline & pipeline_ ) noexcept {
+    for ( std::size_t j = 0; j < ParticleBlock::lanes; ++j ) {
+        block_.lifetime [ j ] -= step_.dt;
+        block_.age [ j ] = std::clamp ( 1.0f - block_.lifetime [ j ] * block_.inverse_lifetime [ j ], 0.0f, 1.0f );
+        block_.color [ j ] = particleColor ( block_.lifetime [ j ], step_ );
+    }
+    pipeline_ ( block_, step_.dt );
+    for ( std::size_t j = 0; j < ParticleBlock::lanes; ++j ) {
+        block_.position_x [ j ] += block_.velocity_x [ j ] * step_.dt;
+        block_.position_y [ j ] += block_.velocity_y [ j ] * step_.dt;
+    }
+}
+
+inline void loadBlock ( ParticleBlock & block_, const ParticleArrays & particles_, const std::size_t j_, const std::size_t k_ ) noexcept {
+    block_.position_x [ j_ ] = particles_.position_x [ k_ ];
+    block_.position_y [ j_ ] = particles_.position_y [ k_ ];
+    block_.velocity_x [ j_ ] = particles_.velocity_x [ k_ ];
+    block_.velocity_y [ j_ ] = particles_.velocity_y [ k_ ];
+    block_.lifetime [ j_ ] = particles_.lifetime [ k_ ];
+    block_.inverse_lifetime [ j_ ] = particles_.inverse_lifetime [ k_ ];
+    block_.scale [ j_ ] = particles_.scale [ k_ ];
+    block_.rotation [ j_ ] = particles_.rotation [ k_ ];
+}
+
+inline void storeBlock ( const ParticleBlock & block_, ParticleArrays & particles_, const std::size_t j_, const std::size_t k_ ) noexcept {
+    particles_.position_x [ k_ ] = block_.position_x [ j_ ];
+    particles_.position_y [ k_ ] = block_.position_y [ j_ ];
+    particles_.velocity_x [ k_ ] = block_.velocity_x [ j_ ];
+    particles_.velocity_y [ k_ ] = block_.velocity_y [ j_ ];
+    particles_.lifetime [ k_ ] = block_.lifetime [ j_ ];
+    particles_.scale [ k_ ] = block_.scale [ j_ ];
+    particles_.rotation [ k_ ] = block_.rotation [ j_ ];
+    particles_.color [ k_ ] = block_.color [ j_ ];
+}
+
+// Contiguous blocks, an array at a time.
+inline void loadBlock ( ParticleBlock & block_, const ParticleArrays & particles_, const std::size_t i_ ) noexcept {
+    std::copy_n ( particles_.position_x.data ( ) + i_, ParticleBlock::lanes, block_.position_x );
+    std::copy_n ( particles_.position_y.data ( ) + i_, ParticleBlock::lanes, block_.position_y );
+    std::copy_n ( particles_.velocity_x.data ( ) + i_, ParticleBlock::lanes, block_.velocity_x );
+    std::copy_n ( particles_.velocity_y.data ( ) + i_, ParticleBlock::lanes, block_.velocity_y );
+    std::copy_n ( particles_.lifetime.data ( ) + i_, ParticleBlock::lanes, block_.lifetime );
+    std::copy_n ( particles_.inverse_lifetime.data ( ) + i_, ParticleBlock::lanes, block_.inverse_lifetime );
+    std::copy_n ( particles_.scale.data ( ) + i_, ParticleBlock::lanes, block_.scale );
+    std::copy_n ( particles_.rotation.data ( ) + i_, ParticleBlock::lanes, block_.rotation );
+}
+
+inline void storeBlock ( const ParticleBlock & block_, ParticleArrays & particles_, const std::size_t i_ ) noexcept {
+    std::copy_n ( block_.position_x, ParticleBlock::lanes, particles_.position_x.data ( ) + i_ );
+    std::copy_n ( block_.position_y, ParticleBlock::lanes, particles_.position_y.data ( ) + i_ );
+    std::copy_n ( block_.velocity_x, ParticleBlock::lanes, particles_.velocity_x.data ( ) + i_ );
+    std::copy_n ( block_.velocity_y, ParticleBlock::lanes, particles_.velocity_y.data ( ) + i_ );
+    std::copy_n ( block_.lifetime, ParticleBlock::lanes, particles_.lifetime.data ( ) + i_ );
+    std::copy_n ( block_.scale, ParticleBlock::lanes, particles_.scale.data ( ) + i_ );
+    std::copy_n ( block_.rotation, ParticleBlock::lanes, particles_.rotation.data ( ) + i_ );
+    std::copy_n ( block_.color, ParticleBlock::lanes, particles_.color.data ( ) + i_ );
+}
+
+// The update kernel with pipeline_ applied, see ParticleUpdateKernel.
+template<typename Pipeline>
+void updateParticles ( ParticleArrays & particles_, const std::size_t begin_, const std::size_t end_, const ParticleStep & step_, Uint8 * respawn_mask_, const Pipeline & pipeline_ ) noexcept {
+    ParticleBlock block;
+    for ( std::size_t i = begin_; i < end_; i += ParticleBlock::lanes ) {
+        loadBlock ( block, particles_, i );
+        affectBlock ( block, step_, pipeline_ );
+        storeBlock ( block, particles_, i );
+        Uint8 mask = 0u;
+        for ( std::size_t j = 0; j < ParticleBlock::lanes; ++j )
+            mask |= ( Uint8 ) ( block.lifetime [ j ] <= 0.0f ) << j;
+        respawn_mask_ [ i / ParticleBlock::lanes ] = mask;
+    }
+}
+
+// The alive list update with pipeline_ applied, see updateAliveParticles.
+template<typename Pipeline>
+std::size_t updateAliveParticles ( ParticleArrays & particles_, Uint32 * alive_, const std::size_t n_, Uint32 * dead_, std::size_t & dead_count_, const ParticleStep & step_, const Pipeline & pipeline_ ) noexcept {
+    ParticleBlock block { };
+    Uint32 index [ ParticleBlock::lanes ];
+    std::size_t alive = 0;
+    for ( std::size_t i = 0; i < n_; i += ParticleBlock::lanes ) {
+        // The lanes past the end of a short last block hold stale values, they
+        // are computed but not stored.
+        const std::size_t l = std::min ( n_ - i, ParticleBlock::lanes );
+        for ( std::size_t j = 0; j < l; ++j ) {
+            index [ j ] = alive_ [ i + j ];
+            loadBlock ( block, particles_, j, index [ j ] );
+        }
+        affectBlock ( block, step_, pipeline_ );
+        for ( std::size_t j = 0; j < l; ++j ) {
+            storeBlock ( block, particles_, j, index [ j ] );
+            if ( block.lifetime [ j ] > 0.0f ) {
+                alive_ [ alive++ ] = index [ j ];
+            }
+            else {
+                dead_ [ dead_count_++ ] = index [ j ];
+            }
+        }
+    }
+    return alive;
+}
+}
+
+
+template<typename... Affectors>
+void ParticleSystemSoA::update ( Time elapsed_, const Color color_, const AffectorPipeline<Affectors...> & pipeline_ ) {
+    if ( not m_culling.tick ( elapsed_ ) )
+        return;
+    const detail::ParticleStep step = makeStep ( elapsed_, color_ );
+    updateChunks ( step, detail::SerialFor { }, [ this, & step, & pipeline_ ] ( const std::size_t c_ ) { integrateChunk ( c_, step, pipeline_ ); } );
+}
+
+template<typename... Affectors>
+void ParticleSystemSoA::update ( Time elapsed_, const Color color_, const AffectorPipeline<Affectors...> & pipeline_, ThreadPool & pool_ ) {
+    if ( not m_culling.tick ( elapsed_ ) )
+        return;
+    const detail::ParticleStep step = makeStep ( elapsed_, color_ );
+    updateChunks ( step, [ & pool_ ] ( const std::size_t n_, auto && f_ ) { pool_.parallelFor ( n_, f_ ); }, [ this, & step, & pipeline_ ] ( const std::size_t c_ ) { integrateChunk ( c_, step, pipeline_ ); } );
+}
+
+template<typename Pipeline>
+void ParticleSystemSoA::integrateChunk ( const std::size_t chunk_, const detail::ParticleStep & step_, const Pipeline & pipeline_ ) noexcept {
+    Chunk & chunk = m_chunks [ chunk_ ];
+    const std::size_t begin = chunk_ * chunk_size, end = std::min ( begin + chunk_size, m_particles.lifetime.size ( ) );
+    if ( m_alive_list ) {
+        std::size_t dead = chunk.dead;
+        chunk.alive = ( Uint32 ) detail::updateAliveParticles ( m_particles, m_alive.data ( ) + begin, chunk.alive, m_dead.data ( ) + begin, dead, step_, pipeline_ );
+        chunk.dead = ( Uint32 ) dead;
+        return;
+    }
+    detail::updateParticles ( m_particles, begin, end, step_, m_respawn_mask.data ( ), pipeline_ );
+    collectDead ( chunk_ );
+}
+
+}
@@ -0,0 +1,94 @@
+
+// MIT License
+//
+// Copyright (c) 2019 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "Extensions.hpp"
+
+namespace sf {
+
+// Draws the vertices of many particle systems with a single draw call from
+// one persistent vertex buffer (stream usage), or from a client side array
+// where vertex buffers are not available. The transform of each system is
+// applied on the cpu, so systems can move independently. update ( ) copies
+// and uploads only the systems whose vertices or transform changed.
+class ParticleBatch : public Drawable, public Transformable {
+    public:
+    explicit ParticleBatch ( const PrimitiveType type_ = sf::Points );
+
+    // System needs getVertices ( ), getVersion ( ) and getTransform ( ), like
+    // ParticleSystem and ParticleSystemSoA, and has to stay at its address
+    // while in the batch. Its vertices must be of the primitive type of the
+    // batch.
+    template<typename System>
+    void add ( const System & system_ ) {
+        Source source;
+        source.system = & system_;
+        source.transformable = & system_;
+        source.vertices = [ ] ( const void * system_ ) -> const VertexArray & { return static_cast<const System *> ( system_ )->getVertices ( ); };
+        source.version = [ ] ( const void * system_ ) -> Uint64 { return static_cast<const System *> ( system_ )->getVersion ( ); };
+        addSource ( source );
+    }
+    void remove ( const void * system_ );
+    void clear ( );
+
+    // Gathers the vertices of the systems, call after updating them.
+    void update ( );
+
+    std::size_t getVertexCount ( ) const noexcept {
+        return m_count;
+    }
+
+    private:
+    virtual void draw ( RenderTarget & target_, RenderStates states_ ) const;
+
+    struct Source {
+        const void * system = nullptr;
+        const Transformable * transformable = nullptr;
+        const VertexArray & ( * vertices ) ( const void * ) = nullptr;
+        Uint64 ( * version ) ( const void * ) = nullptr;
+        // What is in the buffer.
+        std::size_t offset = 0, count = 0;
+        Uint64 uploaded_version = 0;
+        Transform uploaded_transform;
+        bool uploaded = false;
+    };
+
+    void addSource ( const Source & source_ );
+    void markDirty ( const std::size_t begin_, const std::size_t end_ );
+
+    std::vector<Source> m_sources;
+    std::vector<Vertex> m_vertices; // All vertices, transformed, mirrors the buffer.
+    VertexBuffer m_buffer;
+    std::vector<std::pair<std::size_t, std::size_t>> m_dirty; // [ begin, end ) ranges to upload, ascending.
+    std::size_t m_count = 0;
+    PrimitiveType m_type;
+    bool m_use_buffer;
+};
+
+}
@@ -23,20 +23,131 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <limits>
 #include <vector>
 
 #include <SFML/Graphics.hpp>
 
+#include <sax/prng.hpp>
+
+#include "Extensions.hpp"
+
 namespace sf {
 
 using IntInterval = Vector2i;
 
+// What an emitter spawns. A particle leaves in a direction drawn from the cone
+// direction +/- spread / 2 (radians), a spread of two_pi emits all around.
+struct EmitterParameters {
+    IntInterval speed { 50, 100 };         // Pixels per second.
+    IntInterval lifetime { 1'000, 3'000 }; // Milliseconds.
+    float direction = 0.0f, spread = two_pi;
+    float rate = 0.0f; // Particles per second, 0 respawns every dead particle at once.
+};
+
+namespace detail {
+// EmitterParameters as scale and offset factors, computed once when they
+// change. The angle of a particle is ( u - 0.5 ) * spread, rotated by the
+// direction, u uniform in [ 0, 1 ).
+struct EmitterFactors {
+    float spread, direction_cos, direction_sin;
+    float speed_min, speed_range;       // Pixels per second.
+    float lifetime_min, lifetime_range; // Seconds.
+    float rate;
+
+    explicit EmitterFactors ( const EmitterParameters & parameters_ ) noexcept;
+};
+
+// Per frame constants of the update kernel.
+struct ParticleStep {
+    float dt;          // Elapsed seconds.
+    float alpha_scale; // 255 / lifetime at which a particle is fully opaque.
+    Uint32 rgb;        // Packed color, alpha byte zero.
+};
+
+// Alpha (transparency) of the particle according to its lifetime.
+inline Uint32 particleColor ( const float lifetime_, const ParticleStep & step_ ) noexcept {
+    // Through Int32, float to signed converts in one instruction.
+    return step_.rgb | ( Uint32 ) ( Int32 ) std::clamp ( lifetime_ * step_.alpha_scale, 0.0f, 255.0f ) << 24;
+}
+
+// Running bounds of particle positions and the largest scale among them.
+struct ParticleBounds {
+    float min_x = std::numeric_limits<float>::infinity ( ), min_y = std::numeric_limits<float>::infinity ( );
+    float max_x = -std::numeric_limits<float>::infinity ( ), max_y = -std::numeric_limits<float>::infinity ( );
+    float max_scale = 0.0f;
+
+    void add ( const float x_, const float y_, const float scale_ = 1.0f ) noexcept {
+        min_x = std::min ( min_x, x_ );
+        min_y = std::min ( min_y, y_ );
+        max_x = std::max ( max_x, x_ );
+        max_y = std::max ( max_y, y_ );
+        max_scale = std::max ( max_scale, scale_ );
+    }
+    void add ( const ParticleBounds & other_ ) noexcept {
+        min_x = std::min ( min_x, other_.min_x );
+        min_y = std::min ( min_y, other_.min_y );
+        max_x = std::max ( max_x, other_.max_x );
+        max_y = std::max ( max_y, other_.max_y );
+        max_scale = std::max ( max_scale, other_.max_scale );
+    }
+
+    // The box, grown by extent_ times the largest scale on every side. Empty
+    // if nothing was added.
+    FloatRect rect ( const Vector2f extent_ ) const noexcept {
+        if ( min_x > max_x )
+            return FloatRect ( );
+        const float ex = extent_.x * max_scale, ey = extent_.y * max_scale;
+        return FloatRect ( min_x - ex, min_y - ey, max_x - min_x + 2.0f * ex, max_y - min_y + 2.0f * ey );
+    }
+};
+
+// Bounds, view culling and off screen level of detail of a particle system.
+struct ParticleCulling {
+    FloatRect bounds;            // Of the live particles, local.
+    Time pending;                // Elapsed time of the skipped updates.
+    Uint32 divisor = 1u;         // Off screen, update every divisor-th frame.
+    Uint32 skipped = 0u;
+    bool enabled = false;
+    mutable bool visible = true; // As of the last draw.
+
+    // Whether to update this frame. If so, elapsed_ includes the time of the
+    // frames skipped before, so the particles catch up in one step.
+    bool tick ( Time & elapsed_ ) noexcept;
+    // Whether bounds, transformed by transform_, intersect the view of
+    // target_. Remembered for tick.
+    bool isVisible ( const RenderTarget & target_, const Transform & transform_ ) const;
+};
+
+// Calls f_ ( i ) for i in [ 0, n_ ), the serial counterpart of
+// ThreadPool::parallelFor.
+struct SerialFor {
+    template<typename Task>
+    void operator ( ) ( const std::size_t n_, Task && f_ ) const {
+        for ( std::size_t i = std::size_t { 0 }; i < n_; ++i )
+            f_ ( i );
+    }
+};
+
+// Whole particles to spawn this frame, at most rate_ * dt_ plus the fraction
+// carried over in credit_. Unused budget is not saved up, so a system that ran
+// out of dead particles doesn't burst later.
+inline std::size_t spawnBudget ( float & credit_, const float rate_, const float dt_ ) noexcept {
+    credit_ += rate_ * dt_;
+    const float whole = std::floor ( credit_ );
+    credit_ -= whole;
+    return ( std::size_t ) whole;
+}
+}
+
 struct Particle {
     Vector2f velocity;
     Time lifetime;
-    Particle ( ) noexcept;
-    void randomize ( ) noexcept;
+    Particle ( ) noexcept; // Randomized with the default EmitterParameters.
+    void randomize ( const detail::EmitterFactors & factors_ ) noexcept;
 };
 
 class ParticleSystem : public Drawable, public Transformable, public Vertex, Color {
@@ -48,16 +159,51 @@ class ParticleSystem : public Drawable, public Transformable, public Vertex, Col
     virtual void draw ( RenderTarget & target_, RenderStates states_ ) const {
         // Apply the transform.
         states_.transform *= getTransform ( );
+        if ( not m_culling.isVisible ( target_, states_.transform ) )
+            return;
         // Our particles don't use a texture.
         states_.texture = NULL;
         // Draw the vertex array.
         target_.draw ( m_vertices, states_ );
     }
 
+    public:
+    void setEmitterParameters ( const EmitterParameters & parameters_ ) noexcept;
+    const EmitterParameters & getEmitterParameters ( ) const noexcept {
+        return m_parameters;
+    }
+
+    // With culling, draw skips the system if the bounds of its live particles
+    // are outside the view. While skipped, it updates every divisor_-th frame
+    // only, with the elapsed time of the frames in between.
+    void setCulling ( const bool enabled_, const Uint32 divisor_ = 1u ) noexcept {
+        m_culling.enabled = enabled_;
+        m_culling.divisor = std::max ( divisor_, 1u );
+    }
+    bool isCullingEnabled ( ) const noexcept {
+        return m_culling.enabled;
+    }
+    // Local bounds of the live particles, as of the last update.
+    FloatRect getBounds ( ) const noexcept {
+        return m_culling.bounds;
+    }
+
+    // The vertices as drawn, without the transform, and a counter that
+    // changes whenever they do, for ParticleBatch.
+    const VertexArray & getVertices ( ) const noexcept {
+        return m_vertices;
+    }
+    Uint64 getVersion ( ) const noexcept {
+        return m_version;
+    }
+
     private:
     void resetParticle ( const std::size_t index );
+    void syncEmitterParameters ( ) noexcept;
 
     public:
+    // The speed and lifetime of getEmitterParameters ( ), an assignment takes
+    // effect at the next update.
     IntInterval speed, lifetime;
     Vector2f emitter;
 
@@ -65,6 +211,271 @@ class ParticleSystem : public Drawable, public Transformable, public Vertex, Col
     std::vector<Particle> m_particles;
     VertexArray m_vertices;
     Time m_lifetimes;
+    EmitterParameters m_parameters;
+    detail::EmitterFactors m_factors;
+    float m_spawn_credit = 0.0f;
+    Uint64 m_version = 0;
+    detail::ParticleCulling m_culling;
 };
 
+
+class ThreadPool;
+
+template<typename... Affectors>
+class AffectorPipeline;
+
+
+// Seedable generator of 8 interleaved xorshift32 streams that are stepped
+// together, so that stepping vectorizes. Meets UniformRandomBitGenerator.
+struct alignas ( 64 ) ParticleRng {
+    using result_type = Uint32;
+
+    static constexpr std::size_t lanes = 8;
+
+    // Different streams of the same seed are independent.
+    ParticleRng ( const Uint64 seed_ = 0u, const Uint64 stream_ = 0u ) noexcept;
+
+    static constexpr result_type min ( ) noexcept {
+        return 1u; // Xorshift never yields 0.
+    }
+    static constexpr result_type max ( ) noexcept {
+        return 0xFFFF'FFFFu;
+    }
+
+    result_type operator ( ) ( ) noexcept {
+        if ( lanes == m_index ) {
+            step ( );
+            m_index = 0;
+        }
+        return m_state [ m_index++ ];
+    }
+
+    void step ( ) noexcept {
+        for ( Uint32 & x : m_state ) {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+        }
+    }
+
+    // Steps and returns all lanes, for bulk generation.
+    const Uint32 * next ( ) noexcept {
+        step ( );
+        m_index = lanes;
+        return m_state.data ( );
+    }
+
+    private:
+    std::array<Uint32, lanes> m_state;
+    std::size_t m_index = lanes;
+};
+
+
+// Structure-of-arrays particle storage. Every array holds the same number of
+// elements, padded up to a multiple of lanes, and is aligned for vector loads.
+struct ParticleArrays {
+    static constexpr std::size_t lanes = 8;
+
+    AlignedVector<float> position_x, position_y, velocity_x, velocity_y, lifetime;
+    AlignedVector<float> inverse_lifetime; // 1 / lifetime at spawn, for affectors.
+    AlignedVector<float> scale;            // Particle size, written by affectors, 1 at spawn.
+    AlignedVector<float> rotation;         // Radians, written by affectors, 0 at spawn.
+    AlignedVector<Uint32> color;           // Packed sf::Color, red in the low byte.
+
+    void resize ( const std::size_t count_ );
+
+    std::size_t size ( ) const noexcept {
+        return m_size;
+    }
+
+    private:
+    std::size_t m_size = 0;
+};
+
+// Same behaviour as ParticleSystem, but updates the particles from separate
+// contiguous arrays, 8 at a time with the widest instruction set available,
+// and writes the vertices in a final pass. The particles are split in chunks,
+// each with its own random stream, so the result only depends on the seed,
+// not on the thread pool (if any) the update runs on. Dead particles are
+// collected and respawned per chunk in one batch.
+class ParticleSystemSoA : public Drawable, public Transformable {
+    public:
+    // Particles per chunk, a multiple of the lanes and of a cache line.
+    static constexpr std::size_t chunk_size = 4'096;
+
+    ParticleSystemSoA ( const Uint32 count_, const IntInterval speed_ = IntInterval { 50, 100 }, const IntInterval lifetime_ = IntInterval { 1'000, 3'000 }, const Uint64 seed_ = 0u );
+    void update ( const Time elapsed, const Color Color/* = sf::Color::White*/ );
+    // Update the chunks in parallel on pool_.
+    void update ( const Time elapsed, const Color Color, ThreadPool & pool_ );
+    // Update with the affectors of pipeline_ applied in the same pass, see
+    // ParticleAffectors.hpp.
+    template<typename... Affectors>
+    void update ( const Time elapsed_, const Color color_, const AffectorPipeline<Affectors...> & pipeline_ );
+    template<typename... Affectors>
+    void update ( const Time elapsed_, const Color color_, const AffectorPipeline<Affectors...> & pipeline_, ThreadPool & pool_ );
+
+    // Limits the update kernel to level_ (or what the cpu supports, if less).
+    void setSimdLevel ( const SimdLevel level_ ) noexcept;
+    SimdLevel getSimdLevel ( ) const noexcept {
+        return m_simd_level;
+    }
+
+    // Speed, lifetime and direction of the respawned particles, and the rate
+    // at which they respawn.
+    void setEmitterParameters ( const EmitterParameters & parameters_ ) noexcept;
+    const EmitterParameters & getEmitterParameters ( ) const noexcept {
+        return m_parameters;
+    }
+
+    // Dead particles are only respawned while emitting (the default).
+    void setEmitting ( const bool emitting_ ) noexcept {
+        m_emitting = emitting_;
+    }
+    bool isEmitting ( ) const noexcept {
+        return m_emitting;
+    }
+
+    // Keep a dense list of the live particles and only update and draw those,
+    // instead of walking all slots. Pays off if most particles are dead, i.e.
+    // after emitting stopped.
+    void setAliveListEnabled ( const bool enabled_ );
+    bool isAliveListEnabled ( ) const noexcept {
+        return m_alive_list;
+    }
+
+    // Draw every particle as a quad (sf::Quads) of size_ times its scale,
+    // centered on its position, instead of as a point. texture_rect_ is in
+    // texture pixels, with rotate_ the quads are turned by their rotation.
+    void setQuads ( const Vector2f size_, const FloatRect texture_rect_ = FloatRect ( ), const bool rotate_ = false );
+    void setPoints ( );
+    bool isQuads ( ) const noexcept {
+        return m_quads;
+    }
+    // Texture of the quads, not owned.
+    void setTexture ( const Texture * texture_ ) noexcept {
+        m_texture = texture_;
+    }
+
+    // With culling, draw skips the system if the bounds of its live particles
+    // are outside the view. While skipped, it updates every divisor_-th frame
+    // only, with the elapsed time of the frames in between.
+    void setCulling ( const bool enabled_, const Uint32 divisor_ = 1u ) noexcept {
+        m_culling.enabled = enabled_;
+        m_culling.divisor = std::max ( divisor_, 1u );
+    }
+    bool isCullingEnabled ( ) const noexcept {
+        return m_culling.enabled;
+    }
+    // Local bounds of the live particles, as of the last update.
+    FloatRect getBounds ( ) const noexcept {
+        return m_culling.bounds;
+    }
+
+    // The vertices as drawn, without the transform, and a counter that
+    // changes whenever they do, for ParticleBatch.
+    const VertexArray & getVertices ( ) const noexcept {
+        return m_vertices;
+    }
+    Uint64 getVersion ( ) const noexcept {
+        return m_version;
+    }
+
+    private:
+    virtual void draw ( RenderTarget & target_, RenderStates states_ ) const {
+        // Apply the transform.
+        states_.transform *= getTransform ( );
+        if ( not m_culling.isVisible ( target_, states_.transform ) )
+            return;
+        // Points don't use a texture.
+        states_.texture = m_quads ? m_texture : NULL;
+        // Draw the vertex array.
+        target_.draw ( m_vertices, states_ );
+    }
+
+    private:
+    struct Chunk {
+        ParticleRng rng;
+        Uint32 alive = 0, dead = 0; // List lengths, dead also in mask mode.
+        Uint32 spawn = 0;           // Dead particles to respawn this frame.
+        Uint32 vertex_offset = 0;   // Alive list only.
+        detail::ParticleBounds bounds; // Of the live particles, as emitted.
+    };
+
+    bool isRateLimited ( ) const noexcept {
+        return m_emitting and m_factors.rate > 0.0f;
+    }
+    detail::ParticleStep makeStep ( const Time elapsed_, const Color color_ ) const noexcept;
+    // Runs integrate_ ( c ), then the respawns, for every chunk c. for_each_
+    // ( n, f ) calls f ( i ) for i in [ 0, n ), serially or on a pool. Without
+    // a rate limit a chunk is updated in one go, with one the budget is shared
+    // out over all chunks between integrating and respawning.
+    template<typename ForEach, typename Integrate>
+    void updateChunks ( const detail::ParticleStep & step_, ForEach && for_each_, Integrate && integrate_ );
+    void integrateChunk ( const std::size_t chunk_, const detail::ParticleStep & step_ ) noexcept;
+    template<typename Pipeline>
+    void integrateChunk ( const std::size_t chunk_, const detail::ParticleStep & step_, const Pipeline & pipeline_ ) noexcept;
+    void collectDead ( const std::size_t chunk_ ) noexcept;
+    void budgetSpawns ( const float dt_ ) noexcept;
+    void spawnChunk ( const std::size_t chunk_, const detail::ParticleStep & step_ ) noexcept;
+    std::size_t verticesPerParticle ( ) const noexcept {
+        return m_quads ? 4 : 1;
+    }
+    void layoutVertices ( );
+    void emitAllVertices ( );
+    void emitVertices ( const std::size_t chunk_ ) noexcept;
+    void updateBounds ( ) noexcept;
+    void emitAliveVertices ( const std::size_t chunk_ ) noexcept;
+    void emitQuad ( const std::size_t particle_, Vertex * quad_ ) const noexcept;
+    void syncEmitterParameters ( ) noexcept;
+
+    public:
+    // The speed and lifetime of getEmitterParameters ( ), an assignment takes
+    // effect at the next update.
+    IntInterval speed, lifetime;
+    Vector2f emitter;
+
+    private:
+    ParticleArrays m_particles;
+    std::vector<Uint8> m_respawn_mask;
+    // Per chunk index lists, chunk c uses [ c * chunk_size, c * chunk_size + chunk_size ).
+    AlignedVector<Uint32> m_alive, m_dead;
+    std::vector<Chunk> m_chunks;
+    VertexArray m_vertices;
+    Time m_lifetimes;
+    EmitterParameters m_parameters;
+    detail::EmitterFactors m_factors;
+    float m_spawn_credit = 0.0f;
+    std::size_t m_spawn_cursor = 0; // Chunk first in line for the budget, rotates.
+    Uint64 m_version = 0;
+    detail::ParticleCulling m_culling;
+    Vector2f m_quad_half_size;
+    Vector2f m_quad_tex_coords [ 4 ];
+    const Texture * m_texture = nullptr;
+    SimdLevel m_simd_level;
+    bool m_emitting = true, m_alive_list = false, m_quads = false, m_rotate = false;
+};
+
+template<typename ForEach, typename Integrate>
+void ParticleSystemSoA::updateChunks ( const detail::ParticleStep & step_, ForEach && for_each_, Integrate && integrate_ ) {
+    syncEmitterParameters ( );
+    if ( isRateLimited ( ) ) {
+        for_each_ ( m_chunks.size ( ), [ & ] ( const std::size_t c_ ) { integrate_ ( c_ ); } );
+        budgetSpawns ( step_.dt );
+        for_each_ ( m_chunks.size ( ), [ & ] ( const std::size_t c_ ) { spawnChunk ( c_, step_ ); } );
+    }
+    else {
+        for_each_ ( m_chunks.size ( ), [ & ] ( const std::size_t c_ ) {
+            integrate_ ( c_ );
+            m_chunks [ c_ ].spawn = m_chunks [ c_ ].dead;
+            spawnChunk ( c_, step_ );
+        } );
+    }
+    if ( m_alive_list ) {
+        layoutVertices ( );
+        for_each_ ( m_chunks.size ( ), [ this ] ( const std::size_t c_ ) { emitAliveVertices ( c_ ); } );
+    }
+    updateBounds ( );
+    ++m_version;
+}
+
 }
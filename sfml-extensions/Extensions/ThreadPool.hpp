@@ -0,0 +1,80 @@
+
+// MIT License
+//
+// Copyright (c) 2019 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "Extensions.hpp"
+
+namespace sf {
+
+// Persistent worker threads for data parallel loops. The calling thread takes
+// part in the work, so a pool of n workers runs n + 1 tasks concurrently.
+// parallelFor is not reentrant, a task must not call it on the same pool.
+class ThreadPool {
+    public:
+    explicit ThreadPool ( const Uint32 workers_ = std::max ( std::thread::hardware_concurrency ( ), 2u ) - 1u );
+    ThreadPool ( const ThreadPool & ) = delete;
+    ThreadPool & operator = ( const ThreadPool & ) = delete;
+    ~ThreadPool ( );
+
+    // Calls task_ ( i ) for every i in [ 0, count_ ), in any order and on any
+    // thread, and returns when all calls have returned.
+    template<typename Task>
+    void parallelFor ( const std::size_t count_, Task && task_ ) {
+        using TaskType = std::remove_reference_t<Task>;
+        run ( count_, [ ] ( void * task_, const std::size_t i_ ) { ( *static_cast<TaskType *> ( task_ ) ) ( i_ ); }, const_cast<void *> ( static_cast<const void *> ( std::addressof ( task_ ) ) ) );
+    }
+
+    // The number of threads a parallelFor runs on.
+    Uint32 size ( ) const noexcept {
+        return ( Uint32 ) m_workers.size ( ) + 1u;
+    }
+
+    private:
+    using Job = void ( * ) ( void *, const std::size_t );
+
+    void run ( const std::size_t count_, Job job_, void * data_ );
+    void work ( );
+    void drain ( ) noexcept;
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake, m_done;
+    Job m_job = nullptr;
+    void * m_data = nullptr;
+    std::size_t m_count = 0;
+    std::atomic<std::size_t> m_next { 0 };
+    Uint64 m_generation = 0;
+    Uint32 m_busy = 0;
+    bool m_stop = false;
+};
+
+}
@@ -0,0 +1,294 @@
+
+// MIT License
+//
+// Copyright (c) 2019 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <vector>
+
+#include "Extensions.hpp"
+#include "Animation.hpp"
+#include "Delegate.hpp"
+
+namespace sf {
+
+// A timeline of tweens at offsets from its start, built up front and played
+// from one start time. Nothing is created at the step boundaries, a chain of
+// tweens costs no allocation (and no colony insertion) while it plays.
+//
+//     sf::Timeline timeline;
+//     timeline.reserve ( 3u );
+//     timeline.then ( set_x, &sf::easing::quadraticOutEasing::run<float>, 0.0f, 100.0f, std::chrono::milliseconds { 300 } ); // Sequence,
+//     timeline.with ( set_alpha, &sf::easing::linearEasing::run<float>, 0.0f, 255.0f, std::chrono::milliseconds { 400 } ); // parallel,
+//     timeline.then ( set_x, &sf::easing::bounceOutEasing::run<float>, 100.0f, 50.0f, std::chrono::milliseconds { 500 } ); // after both.
+//     timeline.play ( );
+//     timeline.run ( ); // Every frame.
+//
+// The tweens are kept sorted on offset, together with the running maximum of
+// their end offsets, so that the tweens active at a time are a range found
+// with two binary searches: seek is O ( log n ) plus the active tweens, and a
+// run only looks at that range. A run calls each tween that ended since the
+// previous run once more with its end value, in offset order, so the last
+// tween of a chain on the same property wins. A seek calls the tweens that
+// are active at the time (including the ones that end exactly then) and
+// skips the ones that lie before or after it entirely.
+template<typename ClockType = HrClock>
+class BasicTimeline {
+
+    public:
+
+    enum class Status : Int32 { waiting, animating, finished };
+
+    using Callback = Delegate<void ( const float )>;
+    using Clock = ClockType;
+    using Easing = float ( * ) ( float, const float, const float );
+
+    void reserve ( const std::size_t size_ ) {
+        m_offset.reserve ( size_ );
+        m_end_offset.reserve ( size_ );
+        m_max_end_offset.reserve ( size_ );
+        m_inverse_duration.reserve ( size_ );
+        m_start.reserve ( size_ );
+        m_end.reserve ( size_ );
+        m_easing.reserve ( size_ );
+        m_callback.reserve ( size_ );
+    }
+
+    // Adds a tween at offset_ from the start of the timeline, it starts a new
+    // group.
+    void add ( const FloatDuration offset_, Callback callback_, Easing easing_, const float start_, const float end_, const FloatDuration duration_ ) {
+        m_group_offset = offset_.count ( );
+        m_group_end = insert ( m_group_offset, std::move ( callback_ ), easing_, start_, end_, duration_.count ( ) );
+    }
+
+    // Adds a tween gap_ after the end of the previous group, it starts a new
+    // group (sequence).
+    void then ( Callback callback_, Easing easing_, const float start_, const float end_, const FloatDuration duration_, const FloatDuration gap_ = FloatDuration { 0.0f } ) {
+        m_group_offset = m_group_end + gap_.count ( );
+        m_group_end = insert ( m_group_offset, std::move ( callback_ ), easing_, start_, end_, duration_.count ( ) );
+    }
+
+    // Adds a tween lag_ after the start of the current group, to the group
+    // (parallel).
+    void with ( Callback callback_, Easing easing_, const float start_, const float end_, const FloatDuration duration_, const FloatDuration lag_ = FloatDuration { 0.0f } ) {
+        m_group_end = std::max ( m_group_end, insert ( m_group_offset + lag_.count ( ), std::move ( callback_ ), easing_, start_, end_, duration_.count ( ) ) );
+    }
+
+    // Adds all tweens of timeline_ at offset_, as a new group.
+    void add ( const FloatDuration offset_, const BasicTimeline & timeline_ ) {
+        assert ( this != &timeline_ );
+        m_group_offset = offset_.count ( );
+        m_group_end = m_group_offset + timeline_.duration ( );
+        for ( std::size_t i = 0u; i < timeline_.size ( ); ++i ) {
+            insert ( m_group_offset + timeline_.m_offset [ i ], timeline_.m_callback [ i ], timeline_.m_easing [ i ], timeline_.m_start [ i ], timeline_.m_end [ i ], timeline_.m_end_offset [ i ] - timeline_.m_offset [ i ] );
+        }
+    }
+
+    // Adds all tweens of timeline_ after the end of the previous group, as a
+    // new group.
+    void then ( const BasicTimeline & timeline_, const FloatDuration gap_ = FloatDuration { 0.0f } ) {
+        add ( FloatDuration { m_group_end + gap_.count ( ) }, timeline_ );
+    }
+
+    // Starts (or resumes) playing at the current position, after delay_, at the
+    // end it starts over.
+    void play ( const std::chrono::milliseconds delay_ = std::chrono::milliseconds { 0 } ) noexcept {
+        play ( Clock::now ( ), delay_ );
+    }
+
+    void play ( const HrTimePoint now_, const std::chrono::milliseconds delay_ = std::chrono::milliseconds { 0 } ) noexcept {
+        if ( m_position >= duration ( ) ) {
+            rewind ( );
+        }
+        m_start_time = now_ + delay_ - std::chrono::duration_cast<HrClock::duration> ( FloatDuration { std::max ( m_position, 0.0f ) } );
+        m_playing = true;
+    }
+
+    void pause ( ) noexcept {
+        m_playing = false;
+    }
+
+    bool playing ( ) const noexcept {
+        return m_playing;
+    }
+
+    // Samples the clock once, all tweens see the same time.
+    Status run ( ) {
+        return run ( Clock::now ( ) );
+    }
+
+    Status run ( const HrTimePoint now_ ) {
+        if ( not m_playing ) {
+            return m_position < duration ( ) ? Status::waiting : Status::finished;
+        }
+        const float position = std::chrono::duration<float> ( now_ - m_start_time ).count ( );
+        if ( position < 0.0f ) {
+            return Status::waiting;
+        }
+        if ( position < m_position ) {
+            locate ( position );
+        }
+        else {
+            const std::size_t n = size ( );
+            while ( m_next < n and m_offset [ m_next ] <= position ) {
+                ++m_next;
+            }
+        }
+        evaluate ( position, m_position );
+        if ( position < duration ( ) ) {
+            return Status::animating;
+        }
+        m_playing = false;
+        return Status::finished;
+    }
+
+    // Moves to position_ and calls the tweens that are active there, playing
+    // or not. Playing, it goes on from position_ (the end included, it does
+    // not start over).
+    void seek ( const FloatDuration position_ ) {
+        seek ( Clock::now ( ), position_ );
+    }
+
+    void seek ( const HrTimePoint now_, const FloatDuration position_ ) {
+        const float position = std::clamp ( position_.count ( ), 0.0f, duration ( ) );
+        locate ( position );
+        // The tweens that end at position are included.
+        evaluate ( position, std::nextafter ( position, -std::numeric_limits<float>::infinity ( ) ) );
+        if ( m_playing ) {
+            m_start_time = now_ - std::chrono::duration_cast<HrClock::duration> ( FloatDuration { position } );
+        }
+    }
+
+    FloatDuration position ( ) const noexcept {
+        return FloatDuration { std::max ( m_position, 0.0f ) };
+    }
+
+    // The end of the last tween.
+    float duration ( ) const noexcept {
+        return m_max_end_offset.empty ( ) ? 0.0f : m_max_end_offset.back ( );
+    }
+
+    HrTimePoint startTime ( ) const noexcept {
+        return m_start_time;
+    }
+
+    std::size_t size ( ) const noexcept {
+        return m_offset.size ( );
+    }
+
+    bool empty ( ) const noexcept {
+        return m_offset.empty ( );
+    }
+
+    void clear ( ) noexcept {
+        m_offset.clear ( );
+        m_end_offset.clear ( );
+        m_max_end_offset.clear ( );
+        m_inverse_duration.clear ( );
+        m_start.clear ( );
+        m_end.clear ( );
+        m_easing.clear ( );
+        m_callback.clear ( );
+        m_group_offset = m_group_end = 0.0f;
+        rewind ( );
+    }
+
+    // Back to before the start, the next run calls every tween again.
+    void rewind ( ) noexcept {
+        m_position = -1.0f;
+        m_first = m_next = 0u;
+        m_playing = false;
+    }
+
+    private:
+
+    // The tweens in offset order, m_max_end_offset [ i ] is the largest end
+    // offset of the tweens 0...i, it never decreases.
+    std::vector<float> m_offset, m_end_offset, m_max_end_offset, m_inverse_duration, m_start, m_end;
+    std::vector<Easing> m_easing;
+    std::vector<Callback> m_callback;
+
+    // The start and the end of the group then ( ) and with ( ) add to.
+    float m_group_offset = 0.0f, m_group_end = 0.0f;
+
+    // The tweens that can be active are [ m_first, m_next ).
+    std::size_t m_first = 0u, m_next = 0u;
+    float m_position = -1.0f; // Seconds, negative before the start.
+    HrTimePoint m_start_time;
+    bool m_playing = false;
+
+    // Returns the end offset of the tween.
+    float insert ( const float offset_, Callback callback_, Easing easing_, const float start_, const float end_, const float duration_ ) {
+        // After the tweens at the same offset, they keep the order they were added in.
+        const std::size_t i = std::upper_bound ( std::begin ( m_offset ), std::end ( m_offset ), offset_ ) - std::begin ( m_offset );
+        const float end_offset = offset_ + std::max ( duration_, 0.0f );
+        m_offset.insert ( std::begin ( m_offset ) + i, offset_ );
+        m_end_offset.insert ( std::begin ( m_end_offset ) + i, end_offset );
+        m_max_end_offset.insert ( std::begin ( m_max_end_offset ) + i, end_offset );
+        for ( std::size_t j = i, n = size ( ); j < n; ++j ) {
+            m_max_end_offset [ j ] = std::max ( m_end_offset [ j ], j ? m_max_end_offset [ j - 1u ] : 0.0f );
+        }
+        m_inverse_duration.insert ( std::begin ( m_inverse_duration ) + i, duration_ > 0.0f ? 1.0f / duration_ : std::numeric_limits<float>::infinity ( ) );
+        m_start.insert ( std::begin ( m_start ) + i, start_ );
+        m_end.insert ( std::begin ( m_end ) + i, end_ );
+        m_easing.insert ( std::begin ( m_easing ) + i, easing_ );
+        m_callback.insert ( std::begin ( m_callback ) + i, std::move ( callback_ ) );
+        rewind ( );
+        return end_offset;
+    }
+
+    // The range of the tweens that can be active at position_, in O ( log n ).
+    void locate ( const float position_ ) noexcept {
+        m_next = std::upper_bound ( std::begin ( m_offset ), std::end ( m_offset ), position_ ) - std::begin ( m_offset );
+        m_first = std::lower_bound ( std::begin ( m_max_end_offset ), std::begin ( m_max_end_offset ) + m_next, position_ ) - std::begin ( m_max_end_offset );
+    }
+
+    // Calls the tweens in range that are active at position_, and the ones
+    // that ended after since_ with their end value.
+    void evaluate ( const float position_, const float since_ ) {
+        for ( std::size_t i = m_first; i < m_next; ++i ) {
+            if ( m_end_offset [ i ] <= position_ ) {
+                if ( m_end_offset [ i ] > since_ ) {
+                    m_callback [ i ] ( m_end [ i ] );
+                }
+            }
+            else {
+                m_callback [ i ] ( m_easing [ i ] ( ( position_ - m_offset [ i ] ) * m_inverse_duration [ i ], m_start [ i ], m_end [ i ] ) );
+            }
+        }
+        while ( m_first < m_next and m_max_end_offset [ m_first ] < position_ ) {
+            ++m_first;
+        }
+        m_position = position_;
+    }
+};
+
+using Timeline = BasicTimeline<>;
+
+}
@@ -0,0 +1,251 @@
+
+// MIT License
+//
+// Copyright (c) 2019 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <cmath>
+
+#include <algorithm>
+#include <chrono>
+#include <type_traits>
+#include <utility>
+
+#include "Extensions.hpp"
+#include "Animation.hpp"
+#include "Delegate.hpp"
+
+namespace sf {
+
+// The state of a Transformable that is tweened, the origin is left alone.
+// The rotation is in degrees and is interpolated as is, from 350 to 10 turns
+// 340 degrees back, pass 370 as the end to turn 20 degrees forward.
+struct TransformableState {
+
+    Vector2f position, scale { 1.0f, 1.0f };
+    float rotation = 0.0f;
+
+    TransformableState ( ) noexcept = default;
+    TransformableState ( const Vector2f & position_, const Vector2f & scale_, const float rotation_ ) noexcept :
+        position ( position_ ), scale ( scale_ ), rotation ( rotation_ ) {
+    }
+
+    static TransformableState of ( const Transformable & transformable_ ) noexcept {
+        return { transformable_.getPosition ( ), transformable_.getScale ( ), transformable_.getRotation ( ) };
+    }
+
+    void apply ( Transformable & transformable_ ) const noexcept {
+        transformable_.setPosition ( position );
+        transformable_.setScale ( scale );
+        transformable_.setRotation ( rotation );
+    }
+};
+
+
+// The mapping of a tweened type to float channels, and back.
+template<typename T>
+struct TweenTraits;
+
+template<>
+struct TweenTraits<float> {
+    static constexpr std::size_t channels = 1u;
+    static void toChannels ( const float & v_, float * c_ ) noexcept {
+        c_ [ 0 ] = v_;
+    }
+    static float fromChannels ( const float * c_ ) noexcept {
+        return c_ [ 0 ];
+    }
+};
+
+template<>
+struct TweenTraits<Vector2f> {
+    static constexpr std::size_t channels = 2u;
+    static void toChannels ( const Vector2f & v_, float * c_ ) noexcept {
+        c_ [ 0 ] = v_.x; c_ [ 1 ] = v_.y;
+    }
+    static Vector2f fromChannels ( const float * c_ ) noexcept {
+        return { c_ [ 0 ], c_ [ 1 ] };
+    }
+};
+
+template<>
+struct TweenTraits<Vector4f> {
+    static constexpr std::size_t channels = 4u;
+    static void toChannels ( const Vector4f & v_, float * c_ ) noexcept {
+        c_ [ 0 ] = v_.v0; c_ [ 1 ] = v_.v1; c_ [ 2 ] = v_.v2; c_ [ 3 ] = v_.v3;
+    }
+    static Vector4f fromChannels ( const float * c_ ) noexcept {
+        return { c_ [ 0 ], c_ [ 1 ], c_ [ 2 ], c_ [ 3 ] };
+    }
+};
+
+// The easings that overshoot (back, elastic) are clamped to 0...255.
+template<>
+struct TweenTraits<Color> {
+    static constexpr std::size_t channels = 4u;
+    static void toChannels ( const Color & v_, float * c_ ) noexcept {
+        c_ [ 0 ] = v_.r; c_ [ 1 ] = v_.g; c_ [ 2 ] = v_.b; c_ [ 3 ] = v_.a;
+    }
+    static Color fromChannels ( const float * c_ ) noexcept {
+        return { channel ( c_ [ 0 ] ), channel ( c_ [ 1 ] ), channel ( c_ [ 2 ] ), channel ( c_ [ 3 ] ) };
+    }
+    private:
+    static Uint8 channel ( const float c_ ) noexcept {
+        return static_cast<Uint8> ( std::clamp ( c_, 0.0f, 255.0f ) + 0.5f );
+    }
+};
+
+template<>
+struct TweenTraits<TransformableState> {
+    static constexpr std::size_t channels = 5u;
+    static void toChannels ( const TransformableState & v_, float * c_ ) noexcept {
+        c_ [ 0 ] = v_.position.x; c_ [ 1 ] = v_.position.y;
+        c_ [ 2 ] = v_.scale.x; c_ [ 3 ] = v_.scale.y;
+        c_ [ 4 ] = v_.rotation;
+    }
+    static TransformableState fromChannels ( const float * c_ ) noexcept {
+        return { { c_ [ 0 ], c_ [ 1 ] }, { c_ [ 2 ], c_ [ 3 ] }, c_ [ 4 ] };
+    }
+};
+
+
+// A timer that tweens all channels of a T (a Vector2f, Color, ...) with one
+// clock read, one easing evaluation and one callback per run, where a
+// CallbackTimer takes one of each per channel. The easing is evaluated on
+// 0...1 and the channels are interpolated with it, the channels are stored
+// in 16 byte aligned arrays padded to a multiple of 4, so that interpolation
+// compiles to whole SSE (or AVX) operations. Use it with an Animator:
+//
+//     sf::TweenAnimator<sf::Color> fader;
+//     fader.emplace ( [ &sprite ] ( const sf::Color & c ) { sprite.setColor ( c ); }, &sf::easing::quadraticOutEasing::run<float>,
+//         sf::Color::Transparent, sf::Color::White, std::chrono::milliseconds { 500 } );
+template<typename T, typename ClockType = HrClock>
+struct TweenTimer {
+
+    enum class Status : Int32 { waiting, animating, finished };
+
+    using Value = T;
+    using Traits = TweenTraits<T>;
+    using Callback = Delegate<void ( const T & )>;
+    using Clock = ClockType;
+    using Easing = float ( * ) ( float, const float, const float );
+
+    static constexpr std::size_t channels = Traits::channels;
+    static constexpr std::size_t padded = ( channels + 3u ) & ~std::size_t { 3u };
+
+    alignas ( 16 ) float m_start [ padded ] = { };
+    alignas ( 16 ) float m_range [ padded ] = { };
+    Callback m_callback;
+    Easing m_easing;
+    float m_duration;
+    T m_end;
+    HrTimePoint m_start_time;
+
+    TweenTimer ( Callback && callback_, Easing easing_, const T & start_, const T & end_, const FloatDuration duration_, const std::chrono::milliseconds delay_ = std::chrono::milliseconds { 0 } ) noexcept;
+
+    Status run ( ) noexcept;
+    // At time now_, f.e. the frame time, shared by all timers of the frame.
+    Status run ( const HrTimePoint now_ ) noexcept;
+
+    // The end of the delay.
+    HrTimePoint startTime ( ) const noexcept {
+        return m_start_time;
+    }
+
+    // 0 before the start, 1 at the end.
+    float progress ( const HrTimePoint now_ ) const noexcept {
+        return std::clamp ( std::chrono::duration < float > ( now_ - m_start_time ).count ( ) / m_duration, 0.0f, 1.0f );
+    }
+
+    // Tweens from the value at now_ to end_, in the full duration. Before the
+    // start only the end changes.
+    void retarget ( const T & end_, const HrTimePoint now_ ) noexcept;
+
+    void postpone ( const HrClock::duration duration_ ) noexcept {
+        m_start_time += duration_;
+    }
+};
+
+template<typename T, typename Clock>
+TweenTimer<T, Clock>::TweenTimer ( Callback && callback_, Easing easing_, const T & start_, const T & end_, const FloatDuration duration_, const std::chrono::milliseconds delay_ ) noexcept :
+    m_callback ( std::move ( callback_ ) ),
+    m_easing ( easing_ ),
+    m_duration ( duration_.count ( ) ),
+    m_end ( end_ ),
+    m_start_time ( Clock::now ( ) + delay_ ) {
+    Traits::toChannels ( start_, m_start );
+    Traits::toChannels ( end_, m_range );
+    for ( std::size_t i = 0u; i < channels; ++i ) {
+        m_range [ i ] -= m_start [ i ];
+    }
+}
+
+template<typename T, typename Clock>
+void TweenTimer<T, Clock>::retarget ( const T & end_, const HrTimePoint now_ ) noexcept {
+    const float eased = now_ > m_start_time ? m_easing ( progress ( now_ ), 0.0f, 1.0f ) : 0.0f;
+    alignas ( 16 ) float end [ padded ] = { };
+    Traits::toChannels ( end_, end );
+    for ( std::size_t i = 0u; i < padded; ++i ) {
+        m_start [ i ] += m_range [ i ] * eased;
+        m_range [ i ] = end [ i ] - m_start [ i ];
+    }
+    if ( now_ > m_start_time ) {
+        m_start_time = now_;
+    }
+    m_end = end_;
+}
+
+template<typename T, typename Clock>
+typename TweenTimer<T, Clock>::Status TweenTimer<T, Clock>::run ( ) noexcept {
+    return run ( Clock::now ( ) );
+}
+
+template<typename T, typename Clock>
+typename TweenTimer<T, Clock>::Status TweenTimer<T, Clock>::run ( const HrTimePoint now_ ) noexcept {
+    float progress = std::chrono::duration < float > ( now_ - m_start_time ).count ( );
+    if ( progress < 0.0f ) {
+        return Status::waiting;
+    }
+    progress /= m_duration;
+    if ( progress < 1.0f ) {
+        const float eased = m_easing ( progress, 0.0f, 1.0f );
+        alignas ( 16 ) float value [ padded ];
+        for ( std::size_t i = 0u; i < padded; ++i ) {
+            value [ i ] = m_start [ i ] + m_range [ i ] * eased;
+        }
+        m_callback ( Traits::fromChannels ( value ) );
+        return Status::animating;
+    }
+    m_callback ( m_end );
+    return Status::finished;
+}
+
+template<typename T, typename Clock = HrClock>
+using TweenAnimator = Animator<TweenTimer<T, Clock>>;
+
+using Vector2Tween = TweenTimer<Vector2f>;
+using Vector4Tween = TweenTimer<Vector4f>;
+using ColorTween = TweenTimer<Color>;
+using TransformTween = TweenTimer<TransformableState>;
+
+}
@@ -27,7 +27,9 @@
 
 #include "Extensions/LZ4Stream.hpp"
 
-#include <Windows.h>
+#if defined( _WIN32 )
+#    include <Windows.h>
+#endif
 
 #include <cstring>
 
@@ -46,7 +48,9 @@ LZ4Dictionary::LZ4Dictionary ( LZ4Dictionary && other_ ) noexcept {
     other_.size = 0u;
 }
 
+#if defined( _WIN32 )
 LZ4Dictionary::LZ4Dictionary ( int name_ ) { loadFromResource ( name_ ); }
+#endif
 
 LZ4Dictionary::~LZ4Dictionary ( ) {
     if ( nullptr != data )
@@ -61,6 +65,7 @@ LZ4Dictionary::~LZ4Dictionary ( ) {
     return *this;
 }
 
+#if defined( _WIN32 )
 void LZ4Dictionary::loadFromResource ( int name_ ) {
     HRSRC rsrc_data = FindResource ( NULL, MAKEINTRESOURCE ( name_ ), L"FILEDATA" );
     if ( not rsrc_data )
@@ -80,6 +85,7 @@ void LZ4Dictionary::loadFromResource ( int name_ ) {
     if ( not data )
         throw std::runtime_error ( "Failed to load LZ4-dictionary." );
 }
+#endif
 
 static constexpr LZ4F_preferences_t DEFAULT_PREFERENCES = {
     { LZ4F_max256KB, LZ4F_blockLinked, LZ4F_noContentChecksum, LZ4F_frame, 0 /* unknown content size */, 0 /* no dictID */,
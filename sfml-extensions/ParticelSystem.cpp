@@ -21,29 +21,69 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-// #include <algorithm> // std::clamp
+#include <algorithm> // std::clamp
 #include <iostream>
+#include <numeric>
 #include <random>
 
 #include "Extensions/Extensions.hpp"
 #include "Extensions/ParticleSystem.hpp"
+#include "Extensions/ThreadPool.hpp"
+#include "ParticleKernels.hpp"
 
 #include <sax/prng.hpp>
 #include <sax/uniform_int_distribution.hpp>
 
 namespace sf {
 
+namespace detail {
+EmitterFactors::EmitterFactors ( const EmitterParameters & parameters_ ) noexcept :
+    spread ( std::clamp ( parameters_.spread, 0.0f, two_pi ) ),
+    direction_cos ( std::cos ( parameters_.direction ) ), direction_sin ( std::sin ( parameters_.direction ) ),
+    speed_min ( ( float ) parameters_.speed.x ), speed_range ( ( float ) ( parameters_.speed.y - parameters_.speed.x ) ),
+    lifetime_min ( parameters_.lifetime.x / 1'000.0f ), lifetime_range ( ( parameters_.lifetime.y - parameters_.lifetime.x ) / 1'000.0f ),
+    rate ( std::max ( parameters_.rate, 0.0f ) ) {
+}
+
+bool ParticleCulling::tick ( Time & elapsed_ ) noexcept {
+    if ( not enabled or visible or divisor < 2u ) {
+        elapsed_ += pending;
+        pending = Time::Zero;
+        skipped = 0u;
+        return true;
+    }
+    pending += elapsed_;
+    if ( ++skipped < divisor )
+        return false;
+    elapsed_ = pending;
+    pending = Time::Zero;
+    skipped = 0u;
+    return true;
+}
+
+bool ParticleCulling::isVisible ( const RenderTarget & target_, const Transform & transform_ ) const {
+    if ( not enabled )
+        return visible = true;
+    // The view as a world rectangle, the box around it if rotated.
+    const FloatRect view = target_.getView ( ).getInverseTransform ( ).transformRect ( FloatRect ( -1.0f, -1.0f, 2.0f, 2.0f ) );
+    return visible = transform_.transformRect ( bounds ).intersects ( view );
+}
+}
+
 Particle::Particle ( ) noexcept {
-    randomize ( );
+    static const detail::EmitterFactors factors { EmitterParameters { } };
+    randomize ( factors );
 }
 
-void Particle::randomize ( ) noexcept {
-    static sax::Rng rng;
-    const float angle = std::uniform_real_distribution<float> ( 0.0f, two_pi ) ( rng );
-    const float speed = ( float ) sax::uniform_int_distribution<Int32> ( 50, 100 ) ( rng );
-    velocity.x = std::cos ( angle ) * speed;
-    velocity.y = std::sin ( angle ) * speed;
-    lifetime = sf::milliseconds ( sax::uniform_int_distribution<Int32> ( 1'000, 3'000 ) ( rng ) );
+void Particle::randomize ( const detail::EmitterFactors & factors_ ) noexcept {
+    // Particle systems may be constructed and updated on different threads.
+    thread_local sax::Rng rng;
+    const float angle = ( std::generate_canonical<float, 24> ( rng ) - 0.5f ) * factors_.spread;
+    const float speed = factors_.speed_min + std::generate_canonical<float, 24> ( rng ) * factors_.speed_range;
+    const float cos = std::cos ( angle ), sin = std::sin ( angle );
+    velocity.x = ( cos * factors_.direction_cos - sin * factors_.direction_sin ) * speed;
+    velocity.y = ( sin * factors_.direction_cos + cos * factors_.direction_sin ) * speed;
+    lifetime = sf::seconds ( factors_.lifetime_min + std::generate_canonical<float, 24> ( rng ) * factors_.lifetime_range );
 }
 
 ParticleSystem::ParticleSystem ( const Uint32 count_, const IntInterval speed_, const IntInterval lifetime_ ) :
@@ -51,30 +91,366 @@ ParticleSystem::ParticleSystem ( const Uint32 count_, const IntInterval speed_,
     emitter ( 0.0f, 0.0f ),
     m_particles ( count_ ),
     m_vertices ( sf::Points, count_ ),
-    m_lifetimes ( sf::seconds ( 4.0f ) ) {
+    m_lifetimes ( sf::seconds ( 4.0f ) ),
+    m_parameters { speed_, lifetime_ },
+    m_factors ( m_parameters ) {
+    for ( Particle & p : m_particles )
+        p.randomize ( m_factors );
 }
 
-void ParticleSystem::update ( const Time elapsed_, Color color_/* = sf::Color::White*/ ) {
+void ParticleSystem::setEmitterParameters ( const EmitterParameters & parameters_ ) noexcept {
+    m_parameters = parameters_;
+    m_factors = detail::EmitterFactors ( m_parameters );
+    speed = m_parameters.speed;
+    lifetime = m_parameters.lifetime;
+}
+
+void ParticleSystem::syncEmitterParameters ( ) noexcept {
+    if ( speed != m_parameters.speed or lifetime != m_parameters.lifetime ) {
+        m_parameters.speed = speed;
+        m_parameters.lifetime = lifetime;
+        m_factors = detail::EmitterFactors ( m_parameters );
+    }
+}
+
+void ParticleSystem::update ( Time elapsed_, Color color_/* = sf::Color::White*/ ) {
+    if ( not m_culling.tick ( elapsed_ ) )
+        return;
+    syncEmitterParameters ( );
+    const bool limited = m_factors.rate > 0.0f;
+    std::size_t budget = limited ? detail::spawnBudget ( m_spawn_credit, m_factors.rate, elapsed_.asSeconds ( ) ) : 0u;
+    detail::ParticleBounds bounds;
     for ( std::size_t i = std::size_t { 0 }, l = m_particles.size ( ); i < l; ++i ) {
         // Update the particle lifetime.
         Particle & p = m_particles [ i ];
         p.lifetime -= elapsed_;
-        // If the particle is dead, respawn it.
-        if ( p.lifetime <= sf::Time::Zero )
+        // If the particle is dead, respawn it (if the rate allows).
+        if ( p.lifetime <= sf::Time::Zero and ( not limited or budget > 0u ) ) {
             resetParticle ( i );
+            if ( limited )
+                --budget;
+        }
         // Update the position of the corresponding vertex.
         m_vertices [ i ].position += p.velocity * elapsed_.asSeconds ( );
         // Update the alpha (transparency) of the particle according to its lifetime.
-        // color_.a = ( Uint8 ) std::clamp ( p.lifetime.asSeconds ( ) / m_lifetimes.asSeconds ( ), 0.0f, 1.0f ) * 255.0f;
+        color_.a = ( Uint8 ) ( std::clamp ( p.lifetime.asSeconds ( ) / m_lifetimes.asSeconds ( ), 0.0f, 1.0f ) * 255.0f );
         m_vertices [ i ].color = color_;
+        if ( p.lifetime > sf::Time::Zero )
+            bounds.add ( m_vertices [ i ].position.x, m_vertices [ i ].position.y );
     }
+    // A point covers a pixel.
+    m_culling.bounds = bounds.rect ( { 0.5f, 0.5f } );
+    ++m_version;
 }
 
 void ParticleSystem::resetParticle ( const std::size_t index_ ) {
     // Give a random velocity and lifetime to the particle.
-    m_particles [ index_ ].randomize ( );
+    m_particles [ index_ ].randomize ( m_factors );
     // Reset the position of the corresponding vertex.
     m_vertices [ index_ ].position = emitter;
 }
 
+
+
+void ParticleArrays::resize ( const std::size_t count_ ) {
+    // Pad, so that a vector loop never has to peel a tail.
+    const std::size_t padded = ( count_ + lanes - 1 ) & ~( lanes - 1 );
+    position_x.resize ( padded, 0.0f );
+    position_y.resize ( padded, 0.0f );
+    velocity_x.resize ( padded, 0.0f );
+    velocity_y.resize ( padded, 0.0f );
+    lifetime.resize ( padded, 0.0f );
+    inverse_lifetime.resize ( padded, 0.0f );
+    scale.resize ( padded, 1.0f );
+    rotation.resize ( padded, 0.0f );
+    color.resize ( padded, 0u );
+    m_size = count_;
+}
+
+ParticleRng::ParticleRng ( const Uint64 seed_, const Uint64 stream_ ) noexcept {
+    // Seed the lanes with splitmix64.
+    Uint64 x = seed_ ^ ( stream_ + 1u ) * 0xD1B5'4A32'D192'ED03u;
+    for ( Uint32 & s : m_state ) {
+        Uint64 z = ( x += 0x9E37'79B9'7F4A'7C15u );
+        z = ( z ^ ( z >> 30 ) ) * 0xBF58'476D'1CE4'E5B9u;
+        z = ( z ^ ( z >> 27 ) ) * 0x94D0'49BB'1331'11EBu;
+        s = ( Uint32 ) ( z ^ ( z >> 31 ) ) | 1u; // Non-zero.
+    }
+}
+
+ParticleSystemSoA::ParticleSystemSoA ( const Uint32 count_, const IntInterval speed_, const IntInterval lifetime_, const Uint64 seed_ ) :
+    speed ( speed_ ), lifetime ( lifetime_ ),
+    emitter ( 0.0f, 0.0f ),
+    m_vertices ( sf::Points, count_ ),
+    m_lifetimes ( sf::seconds ( 4.0f ) ),
+    m_parameters { speed_, lifetime_ },
+    m_factors ( m_parameters ),
+    m_simd_level ( cpuSimdLevel ( ) ) {
+    m_particles.resize ( count_ );
+    m_respawn_mask.resize ( m_particles.lifetime.size ( ) / ParticleArrays::lanes );
+    m_alive.resize ( m_particles.lifetime.size ( ) );
+    m_dead.resize ( m_particles.lifetime.size ( ) );
+    const std::size_t chunks = ( m_particles.lifetime.size ( ) + chunk_size - 1 ) / chunk_size;
+    m_chunks.resize ( chunks );
+    // Spawn all particles, at the origin, like Particle.
+    const detail::ParticleStep step { 0.0f, 255.0f / m_lifetimes.asSeconds ( ), 0x00FF'FFFFu };
+    for ( std::size_t c = std::size_t { 0 }; c < chunks; ++c ) {
+        const std::size_t begin = c * chunk_size, end = std::min ( begin + chunk_size, std::size_t { count_ } );
+        m_chunks [ c ].rng = ParticleRng ( seed_, c );
+        std::iota ( m_dead.data ( ) + begin, m_dead.data ( ) + end, ( Uint32 ) begin );
+        m_chunks [ c ].dead = m_chunks [ c ].spawn = ( Uint32 ) ( end - begin );
+        spawnChunk ( c, step );
+    }
+}
+
+void ParticleSystemSoA::update ( Time elapsed_, Color color_/* = sf::Color::White*/ ) {
+    if ( not m_culling.tick ( elapsed_ ) )
+        return;
+    const detail::ParticleStep step = makeStep ( elapsed_, color_ );
+    updateChunks ( step, detail::SerialFor { }, [ this, & step ] ( const std::size_t c_ ) { integrateChunk ( c_, step ); } );
+}
+
+void ParticleSystemSoA::update ( Time elapsed_, Color color_, ThreadPool & pool_ ) {
+    if ( not m_culling.tick ( elapsed_ ) )
+        return;
+    const detail::ParticleStep step = makeStep ( elapsed_, color_ );
+    updateChunks ( step, [ & pool_ ] ( const std::size_t n_, auto && f_ ) { pool_.parallelFor ( n_, f_ ); }, [ this, & step ] ( const std::size_t c_ ) { integrateChunk ( c_, step ); } );
+}
+
+void ParticleSystemSoA::setEmitterParameters ( const EmitterParameters & parameters_ ) noexcept {
+    m_parameters = parameters_;
+    m_factors = detail::EmitterFactors ( m_parameters );
+    speed = m_parameters.speed;
+    lifetime = m_parameters.lifetime;
+}
+
+void ParticleSystemSoA::syncEmitterParameters ( ) noexcept {
+    if ( speed != m_parameters.speed or lifetime != m_parameters.lifetime ) {
+        m_parameters.speed = speed;
+        m_parameters.lifetime = lifetime;
+        m_factors = detail::EmitterFactors ( m_parameters );
+    }
+}
+
+void ParticleSystemSoA::setSimdLevel ( const SimdLevel level_ ) noexcept {
+    m_simd_level = std::min ( level_, cpuSimdLevel ( ) );
+}
+
+void ParticleSystemSoA::setAliveListEnabled ( const bool enabled_ ) {
+    if ( enabled_ == m_alive_list ) {
+        return;
+    }
+    m_alive_list = enabled_;
+    if ( m_alive_list ) {
+        // Sort the slots on their lifetime.
+        for ( std::size_t c = std::size_t { 0 }, l = m_chunks.size ( ); c < l; ++c ) {
+            Chunk & chunk = m_chunks [ c ];
+            const std::size_t begin = c * chunk_size, end = std::min ( begin + chunk_size, m_particles.size ( ) );
+            chunk.alive = chunk.dead = 0u;
+            for ( std::size_t i = begin; i < end; ++i ) {
+                if ( m_particles.lifetime [ i ] > 0.0f ) {
+                    m_alive [ begin + chunk.alive++ ] = ( Uint32 ) i;
+                }
+                else {
+                    m_dead [ begin + chunk.dead++ ] = ( Uint32 ) i;
+                }
+            }
+        }
+    }
+    emitAllVertices ( );
+}
+
+void ParticleSystemSoA::setQuads ( const Vector2f size_, const FloatRect texture_rect_, const bool rotate_ ) {
+    m_quad_half_size = size_ * 0.5f;
+    m_quad_tex_coords [ 0 ] = Vector2f ( texture_rect_.left, texture_rect_.top );
+    m_quad_tex_coords [ 1 ] = Vector2f ( texture_rect_.left + texture_rect_.width, texture_rect_.top );
+    m_quad_tex_coords [ 2 ] = Vector2f ( texture_rect_.left + texture_rect_.width, texture_rect_.top + texture_rect_.height );
+    m_quad_tex_coords [ 3 ] = Vector2f ( texture_rect_.left, texture_rect_.top + texture_rect_.height );
+    m_quads = true;
+    m_rotate = rotate_;
+    m_vertices.setPrimitiveType ( sf::Quads );
+    emitAllVertices ( );
+}
+
+void ParticleSystemSoA::setPoints ( ) {
+    m_quads = false;
+    m_vertices.setPrimitiveType ( sf::Points );
+    emitAllVertices ( );
+}
+
+detail::ParticleStep ParticleSystemSoA::makeStep ( const Time elapsed_, const Color color_ ) const noexcept {
+    return { elapsed_.asSeconds ( ), 255.0f / m_lifetimes.asSeconds ( ), detail::packColor ( color_ ) & 0x00FF'FFFFu };
+}
+
+void ParticleSystemSoA::integrateChunk ( const std::size_t chunk_, const detail::ParticleStep & step_ ) noexcept {
+    Chunk & chunk = m_chunks [ chunk_ ];
+    const std::size_t begin = chunk_ * chunk_size, end = std::min ( begin + chunk_size, m_particles.lifetime.size ( ) );
+    if ( m_alive_list ) {
+        std::size_t dead = chunk.dead;
+        chunk.alive = ( Uint32 ) detail::updateAliveParticles ( m_particles, m_alive.data ( ) + begin, chunk.alive, m_dead.data ( ) + begin, dead, step_ );
+        chunk.dead = ( Uint32 ) dead;
+        return;
+    }
+    detail::particleUpdateKernel ( m_simd_level ) ( m_particles, begin, end, step_, m_respawn_mask.data ( ) );
+    collectDead ( chunk_ );
+}
+
+void ParticleSystemSoA::collectDead ( const std::size_t chunk_ ) noexcept {
+    Chunk & chunk = m_chunks [ chunk_ ];
+    const std::size_t begin = chunk_ * chunk_size, end = std::min ( begin + chunk_size, m_particles.lifetime.size ( ) );
+    chunk.dead = 0u;
+    if ( m_emitting ) {
+        // Collect the dead particles, most mask bytes are zero.
+        for ( std::size_t m = begin / ParticleArrays::lanes, l = end / ParticleArrays::lanes; m < l; ++m ) {
+            if ( m_respawn_mask [ m ] ) {
+                for ( std::size_t j = std::size_t { 0 }; j < ParticleArrays::lanes; ++j ) {
+                    const std::size_t i = m * ParticleArrays::lanes + j;
+                    if ( ( m_respawn_mask [ m ] >> j & 1u ) and i < m_particles.size ( ) ) {
+                        m_dead [ begin + chunk.dead++ ] = ( Uint32 ) i;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void ParticleSystemSoA::budgetSpawns ( const float dt_ ) noexcept {
+    // Serve the chunks in turn, starting from a different one every frame,
+    // which only depends on the frame count, not on the threads.
+    std::size_t budget = detail::spawnBudget ( m_spawn_credit, m_factors.rate, dt_ );
+    for ( std::size_t i = std::size_t { 0 }, l = m_chunks.size ( ); i < l; ++i ) {
+        Chunk & chunk = m_chunks [ ( m_spawn_cursor + i ) % l ];
+        chunk.spawn = ( Uint32 ) std::min ( budget, std::size_t { chunk.dead } );
+        budget -= chunk.spawn;
+    }
+    if ( m_chunks.size ( ) )
+        m_spawn_cursor = ( m_spawn_cursor + 1 ) % m_chunks.size ( );
+}
+
+void ParticleSystemSoA::spawnChunk ( const std::size_t chunk_, const detail::ParticleStep & step_ ) noexcept {
+    Chunk & chunk = m_chunks [ chunk_ ];
+    const std::size_t begin = chunk_ * chunk_size;
+    if ( m_emitting and chunk.spawn ) {
+        // Respawn from the back of the dead list, the rest stays dead.
+        const Uint32 * const spawn = m_dead.data ( ) + begin + ( chunk.dead - chunk.spawn );
+        detail::particleRespawnKernel ( m_simd_level ) ( m_particles, spawn, chunk.spawn, chunk.rng, m_factors, emitter, step_ );
+        if ( m_alive_list ) {
+            std::copy_n ( spawn, chunk.spawn, m_alive.data ( ) + begin + chunk.alive );
+            chunk.alive += chunk.spawn;
+        }
+        chunk.dead -= chunk.spawn;
+    }
+    chunk.spawn = 0u;
+    if ( not m_alive_list ) {
+        emitVertices ( chunk_ );
+    }
+}
+
+void ParticleSystemSoA::layoutVertices ( ) {
+    Uint32 offset = 0u;
+    for ( Chunk & chunk : m_chunks ) {
+        chunk.vertex_offset = offset;
+        offset += chunk.alive;
+    }
+    m_vertices.resize ( offset * verticesPerParticle ( ) );
+}
+
+void ParticleSystemSoA::emitAllVertices ( ) {
+    if ( m_alive_list ) {
+        layoutVertices ( );
+        for ( std::size_t c = std::size_t { 0 }, l = m_chunks.size ( ); c < l; ++c ) {
+            emitAliveVertices ( c );
+        }
+    }
+    else {
+        m_vertices.resize ( m_particles.size ( ) * verticesPerParticle ( ) );
+        for ( std::size_t c = std::size_t { 0 }, l = m_chunks.size ( ); c < l; ++c ) {
+            emitVertices ( c );
+        }
+    }
+    updateBounds ( );
+    ++m_version;
+}
+
+// The emit functions also track the bounds of what they emit, so these stay
+// up to date without an extra pass.
+
+void ParticleSystemSoA::emitVertices ( const std::size_t chunk_ ) noexcept {
+    const std::size_t begin = chunk_ * chunk_size, end = std::min ( begin + chunk_size, m_particles.size ( ) );
+    detail::ParticleBounds bounds;
+    if ( m_quads ) {
+        for ( std::size_t i = begin; i < end; ++i ) {
+            emitQuad ( i, & m_vertices [ 4 * i ] );
+            if ( m_particles.lifetime [ i ] > 0.0f )
+                bounds.add ( m_particles.position_x [ i ], m_particles.position_y [ i ], m_particles.scale [ i ] );
+        }
+    }
+    else {
+        for ( std::size_t i = begin; i < end; ++i ) {
+            Vertex & v = m_vertices [ i ];
+            v.position.x = m_particles.position_x [ i ];
+            v.position.y = m_particles.position_y [ i ];
+            v.color = detail::unpackColor ( m_particles.color [ i ] );
+            if ( m_particles.lifetime [ i ] > 0.0f )
+                bounds.add ( v.position.x, v.position.y );
+        }
+    }
+    m_chunks [ chunk_ ].bounds = bounds;
+}
+
+void ParticleSystemSoA::emitAliveVertices ( const std::size_t chunk_ ) noexcept {
+    Chunk & chunk = m_chunks [ chunk_ ];
+    const Uint32 * const alive = m_alive.data ( ) + chunk_ * chunk_size;
+    detail::ParticleBounds bounds;
+    if ( m_quads ) {
+        for ( Uint32 i = 0u; i < chunk.alive; ++i ) {
+            emitQuad ( alive [ i ], & m_vertices [ 4 * ( chunk.vertex_offset + i ) ] );
+            bounds.add ( m_particles.position_x [ alive [ i ] ], m_particles.position_y [ alive [ i ] ], m_particles.scale [ alive [ i ] ] );
+        }
+    }
+    else {
+        for ( Uint32 i = 0u; i < chunk.alive; ++i ) {
+            Vertex & v = m_vertices [ chunk.vertex_offset + i ];
+            v.position.x = m_particles.position_x [ alive [ i ] ];
+            v.position.y = m_particles.position_y [ alive [ i ] ];
+            v.color = detail::unpackColor ( m_particles.color [ alive [ i ] ] );
+            bounds.add ( v.position.x, v.position.y );
+        }
+    }
+    chunk.bounds = bounds;
+}
+
+void ParticleSystemSoA::updateBounds ( ) noexcept {
+    detail::ParticleBounds bounds;
+    for ( const Chunk & chunk : m_chunks ) {
+        bounds.add ( chunk.bounds );
+    }
+    // A point covers a pixel, a quad reaches its half diagonal out if rotated.
+    Vector2f extent ( 0.5f, 0.5f );
+    if ( m_quads )
+        extent = m_rotate ? Vector2f ( 1.0f, 1.0f ) * std::hypot ( m_quad_half_size.x, m_quad_half_size.y ) : m_quad_half_size;
+    m_culling.bounds = bounds.rect ( extent );
+}
+
+void ParticleSystemSoA::emitQuad ( const std::size_t particle_, Vertex * quad_ ) const noexcept {
+    // The half axes u and w of the quad, the corners are p -u -w, p +u -w,
+    // p +u +w and p -u +w.
+    const float scale = m_particles.scale [ particle_ ];
+    const float hx = m_quad_half_size.x * scale, hy = m_quad_half_size.y * scale;
+    float ux = hx, uy = 0.0f, wx = 0.0f, wy = hy;
+    if ( m_rotate ) {
+        const float cos = std::cos ( m_particles.rotation [ particle_ ] ), sin = std::sin ( m_particles.rotation [ particle_ ] );
+        ux = hx * cos;
+        uy = hx * sin;
+        wx = -hy * sin;
+        wy = hy * cos;
+    }
+    const float x = m_particles.position_x [ particle_ ], y = m_particles.position_y [ particle_ ];
+    const Color color = detail::unpackColor ( m_particles.color [ particle_ ] );
+    quad_ [ 0 ] = Vertex ( Vector2f ( x - ux - wx, y - uy - wy ), color, m_quad_tex_coords [ 0 ] );
+    quad_ [ 1 ] = Vertex ( Vector2f ( x + ux - wx, y + uy - wy ), color, m_quad_tex_coords [ 1 ] );
+    quad_ [ 2 ] = Vertex ( Vector2f ( x + ux + wx, y + uy + wy ), color, m_quad_tex_coords [ 2 ] );
+    quad_ [ 3 ] = Vertex ( Vector2f ( x - ux + wx, y - uy + wy ), color, m_quad_tex_coords [ 3 ] );
+}
+
 }
@@ -0,0 +1,113 @@
+
+// MIT License
+//
+// Copyright (c) 2019 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+
+#include "Extensions/ParticleBatch.hpp"
+
+namespace sf {
+
+ParticleBatch::ParticleBatch ( const PrimitiveType type_ ) :
+    m_buffer ( type_, VertexBuffer::Stream ),
+    m_type ( type_ ),
+    m_use_buffer ( VertexBuffer::isAvailable ( ) ) {
+}
+
+void ParticleBatch::addSource ( const Source & source_ ) {
+    m_sources.push_back ( source_ );
+}
+
+void ParticleBatch::remove ( const void * system_ ) {
+    // The systems after it move down, update ( ) sees their offsets change.
+    m_sources.erase ( std::remove_if ( std::begin ( m_sources ), std::end ( m_sources ), [ system_ ] ( const Source & source_ ) { return source_.system == system_; } ), std::end ( m_sources ) );
+}
+
+void ParticleBatch::clear ( ) {
+    m_sources.clear ( );
+}
+
+void ParticleBatch::update ( ) {
+    // Lay out the systems back to back.
+    std::size_t offset = 0;
+    for ( Source & source : m_sources ) {
+        const VertexArray & vertices = source.vertices ( source.system );
+        const std::size_t count = vertices.getVertexCount ( );
+        const Uint64 version = source.version ( source.system );
+        const Transform & transform = source.transformable->getTransform ( );
+        const bool moved = offset != source.offset or count != source.count;
+        const bool transformed = not std::equal ( transform.getMatrix ( ), transform.getMatrix ( ) + 16, source.uploaded_transform.getMatrix ( ) );
+        if ( not source.uploaded or moved or transformed or version != source.uploaded_version ) {
+            if ( m_vertices.size ( ) < offset + count )
+                m_vertices.resize ( offset + count );
+            const bool identity = std::equal ( transform.getMatrix ( ), transform.getMatrix ( ) + 16, Transform::Identity.getMatrix ( ) );
+            for ( std::size_t i = 0; i < count; ++i ) {
+                Vertex & v = m_vertices [ offset + i ];
+                v = vertices [ i ];
+                if ( not identity )
+                    v.position = transform.transformPoint ( v.position );
+            }
+            source.offset = offset;
+            source.count = count;
+            source.uploaded_version = version;
+            source.uploaded_transform = transform;
+            source.uploaded = true;
+            markDirty ( offset, offset + count );
+        }
+        offset += count;
+    }
+    m_count = offset;
+    m_vertices.resize ( m_count );
+    if ( not m_use_buffer ) {
+        m_dirty.clear ( );
+        return;
+    }
+    if ( m_buffer.getVertexCount ( ) < m_count ) {
+        // Grow geometrically, creating the buffer discards its content.
+        m_buffer.create ( std::max ( m_count, m_buffer.getVertexCount ( ) + m_buffer.getVertexCount ( ) / 2 ) );
+        m_dirty.assign ( 1, { 0, m_count } );
+    }
+    for ( const auto & [ begin, end ] : m_dirty ) {
+        if ( end > begin )
+            m_buffer.update ( m_vertices.data ( ) + begin, end - begin, ( unsigned int ) begin );
+    }
+    m_dirty.clear ( );
+}
+
+void ParticleBatch::markDirty ( const std::size_t begin_, const std::size_t end_ ) {
+    // Sources are visited in order, so adjacent ranges merge into one upload.
+    if ( m_dirty.size ( ) and m_dirty.back ( ).second == begin_ )
+        m_dirty.back ( ).second = end_;
+    else
+        m_dirty.emplace_back ( begin_, end_ );
+}
+
+void ParticleBatch::draw ( RenderTarget & target_, RenderStates states_ ) const {
+    // Apply the transform.
+    states_.transform *= getTransform ( );
+    if ( m_use_buffer )
+        target_.draw ( m_buffer, 0, m_count, states_ );
+    else
+        target_.draw ( m_vertices.data ( ), m_count, m_type, states_ );
+}
+
+}
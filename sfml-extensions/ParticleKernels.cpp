@@ -0,0 +1,234 @@
+
+// MIT License
+//
+// Copyright (c) 2019 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ParticleKernels.hpp"
+#include "Simd.hpp"
+
+namespace sf::detail {
+
+static_assert ( 8 == ParticleArrays::lanes, "the kernels process 8 particles per iteration" );
+
+static void updateParticlesScalar ( ParticleArrays & particles_, const std::size_t begin_, const std::size_t end_, const ParticleStep & step_, Uint8 * respawn_mask_ ) noexcept {
+    float * const px = particles_.position_x.data ( ), * const py = particles_.position_y.data ( );
+    const float * const vx = particles_.velocity_x.data ( ), * const vy = particles_.velocity_y.data ( );
+    float * const lt = particles_.lifetime.data ( );
+    Uint32 * const color = particles_.color.data ( );
+    for ( std::size_t i = begin_; i < end_; i += 8 ) {
+        Uint8 mask = 0u;
+        for ( std::size_t j = 0; j < 8; ++j ) {
+            const std::size_t k = i + j;
+            lt [ k ] -= step_.dt;
+            px [ k ] += vx [ k ] * step_.dt;
+            py [ k ] += vy [ k ] * step_.dt;
+            color [ k ] = particleColor ( lt [ k ], step_ );
+            mask |= ( Uint8 ) ( lt [ k ] <= 0.0f ) << j;
+        }
+        respawn_mask_ [ i / 8 ] = mask;
+    }
+}
+
+std::size_t updateAliveParticles ( ParticleArrays & particles_, Uint32 * alive_, const std::size_t n_, Uint32 * dead_, std::size_t & dead_count_, const ParticleStep & step_ ) noexcept {
+    // Gathered, so scalar.
+    float * const px = particles_.position_x.data ( ), * const py = particles_.position_y.data ( );
+    const float * const vx = particles_.velocity_x.data ( ), * const vy = particles_.velocity_y.data ( );
+    float * const lt = particles_.lifetime.data ( );
+    Uint32 * const color = particles_.color.data ( );
+    std::size_t alive = 0;
+    for ( std::size_t i = 0; i < n_; ++i ) {
+        const Uint32 k = alive_ [ i ];
+        lt [ k ] -= step_.dt;
+        px [ k ] += vx [ k ] * step_.dt;
+        py [ k ] += vy [ k ] * step_.dt;
+        color [ k ] = particleColor ( lt [ k ], step_ );
+        if ( lt [ k ] > 0.0f ) {
+            alive_ [ alive++ ] = k;
+        }
+        else {
+            dead_ [ dead_count_++ ] = k;
+        }
+    }
+    return alive;
+}
+
+// Uniform in [ 0, 1 ), from the high 24 bits.
+inline float uniformFloat ( const Uint32 x_ ) noexcept {
+    return ( float ) ( x_ >> 8 ) * ( 1.0f / 16'777'216.0f );
+}
+
+// Sine and cosine of x_ in [ -pi, pi ], max error 4e-6. Reflected into
+// [ -pi / 2, pi / 2 ], where the Taylor polynomials converge fast enough.
+inline void sinCos ( float x_, float & sin_, float & cos_ ) noexcept {
+    float cos_sign = 1.0f;
+    if ( x_ > half_pi ) {
+        x_ = pi - x_;
+        cos_sign = -1.0f;
+    }
+    else if ( x_ < -half_pi ) {
+        x_ = -pi - x_;
+        cos_sign = -1.0f;
+    }
+    const float x2 = x_ * x_;
+    sin_ = x_ * ( 1.0f + x2 * ( -1.0f / 6.0f + x2 * ( 1.0f / 120.0f + x2 * ( -1.0f / 5'040.0f + x2 * ( 1.0f / 362'880.0f ) ) ) ) );
+    cos_ = cos_sign * ( 1.0f + x2 * ( -1.0f / 2.0f + x2 * ( 1.0f / 24.0f + x2 * ( -1.0f / 720.0f + x2 * ( 1.0f / 40'320.0f + x2 * ( -1.0f / 3'628'800.0f ) ) ) ) ) );
+}
+
+// Writes the respawned particle k_ from its new velocity and lifetime.
+inline void scatterParticle ( ParticleArrays & particles_, const Uint32 k_, const float vx_, const float vy_, const float lifetime_, const Vector2f emitter_, const ParticleStep & step_ ) noexcept {
+    particles_.velocity_x [ k_ ] = vx_;
+    particles_.velocity_y [ k_ ] = vy_;
+    particles_.lifetime [ k_ ] = lifetime_;
+    particles_.inverse_lifetime [ k_ ] = 1.0f / lifetime_;
+    particles_.scale [ k_ ] = 1.0f;
+    particles_.rotation [ k_ ] = 0.0f;
+    particles_.position_x [ k_ ] = emitter_.x + vx_ * step_.dt;
+    particles_.position_y [ k_ ] = emitter_.y + vy_ * step_.dt;
+    particles_.color [ k_ ] = particleColor ( lifetime_, step_ );
+}
+
+static void respawnParticlesScalar ( ParticleArrays & particles_, const Uint32 * indices_, const std::size_t n_, ParticleRng & rng_, const EmitterFactors & factors_, const Vector2f emitter_, const ParticleStep & step_ ) noexcept {
+    std::array<Uint32, 8> angle, speed, lifetime;
+    for ( std::size_t i = 0; i < n_; i += 8 ) {
+        std::copy_n ( rng_.next ( ), 8, angle.data ( ) );
+        std::copy_n ( rng_.next ( ), 8, speed.data ( ) );
+        std::copy_n ( rng_.next ( ), 8, lifetime.data ( ) );
+        for ( std::size_t j = 0, l = std::min ( n_ - i, std::size_t { 8 } ); j < l; ++j ) {
+            float sin, cos;
+            sinCos ( ( uniformFloat ( angle [ j ] ) - 0.5f ) * factors_.spread, sin, cos );
+            const float v = factors_.speed_min + uniformFloat ( speed [ j ] ) * factors_.speed_range;
+            // Rotate into the direction of the cone.
+            const float vx = ( cos * factors_.direction_cos - sin * factors_.direction_sin ) * v, vy = ( sin * factors_.direction_cos + cos * factors_.direction_sin ) * v;
+            scatterParticle ( particles_, indices_ [ i + j ], vx, vy, factors_.lifetime_min + uniformFloat ( lifetime [ j ] ) * factors_.lifetime_range, emitter_, step_ );
+        }
+    }
+}
+
+#ifdef SFML_EXTENSIONS_X64
+
+SFML_EXTENSIONS_TARGET_AVX2 inline __m256 uniformFloatAvx2 ( const Uint32 * x_ ) noexcept {
+    return _mm256_mul_ps ( _mm256_cvtepi32_ps ( _mm256_srli_epi32 ( _mm256_load_si256 ( reinterpret_cast<const __m256i *> ( x_ ) ), 8 ) ), _mm256_set1_ps ( 1.0f / 16'777'216.0f ) );
+}
+
+// The sinCos above, 8 at a time.
+SFML_EXTENSIONS_TARGET_AVX2 inline void sinCosAvx2 ( __m256 x_, __m256 & sin_, __m256 & cos_ ) noexcept {
+    const __m256 above = _mm256_cmp_ps ( x_, _mm256_set1_ps ( half_pi ), _CMP_GT_OQ ), below = _mm256_cmp_ps ( x_, _mm256_set1_ps ( -half_pi ), _CMP_LT_OQ );
+    x_ = _mm256_blendv_ps ( x_, _mm256_sub_ps ( _mm256_set1_ps ( pi ), x_ ), above );
+    x_ = _mm256_blendv_ps ( x_, _mm256_sub_ps ( _mm256_set1_ps ( -pi ), x_ ), below );
+    const __m256 cos_sign = _mm256_and_ps ( _mm256_or_ps ( above, below ), _mm256_set1_ps ( -0.0f ) );
+    const __m256 x2 = _mm256_mul_ps ( x_, x_ );
+    __m256 p = _mm256_set1_ps ( 1.0f / 362'880.0f );
+    p = _mm256_add_ps ( _mm256_set1_ps ( -1.0f / 5'040.0f ), _mm256_mul_ps ( x2, p ) );
+    p = _mm256_add_ps ( _mm256_set1_ps ( 1.0f / 120.0f ), _mm256_mul_ps ( x2, p ) );
+    p = _mm256_add_ps ( _mm256_set1_ps ( -1.0f / 6.0f ), _mm256_mul_ps ( x2, p ) );
+    p = _mm256_add_ps ( _mm256_set1_ps ( 1.0f ), _mm256_mul_ps ( x2, p ) );
+    sin_ = _mm256_mul_ps ( x_, p );
+    __m256 q = _mm256_set1_ps ( -1.0f / 3'628'800.0f );
+    q = _mm256_add_ps ( _mm256_set1_ps ( 1.0f / 40'320.0f ), _mm256_mul_ps ( x2, q ) );
+    q = _mm256_add_ps ( _mm256_set1_ps ( -1.0f / 720.0f ), _mm256_mul_ps ( x2, q ) );
+    q = _mm256_add_ps ( _mm256_set1_ps ( 1.0f / 24.0f ), _mm256_mul_ps ( x2, q ) );
+    q = _mm256_add_ps ( _mm256_set1_ps ( -1.0f / 2.0f ), _mm256_mul_ps ( x2, q ) );
+    q = _mm256_add_ps ( _mm256_set1_ps ( 1.0f ), _mm256_mul_ps ( x2, q ) );
+    cos_ = _mm256_xor_ps ( q, cos_sign );
+}
+
+SFML_EXTENSIONS_TARGET_AVX2 static void respawnParticlesAvx2 ( ParticleArrays & particles_, const Uint32 * indices_, const std::size_t n_, ParticleRng & rng_, const EmitterFactors & factors_, const Vector2f emitter_, const ParticleStep & step_ ) noexcept {
+    alignas ( 32 ) float vx [ 8 ], vy [ 8 ], lifetime [ 8 ];
+    const __m256 half = _mm256_set1_ps ( 0.5f ), spread = _mm256_set1_ps ( factors_.spread );
+    const __m256 direction_cos = _mm256_set1_ps ( factors_.direction_cos ), direction_sin = _mm256_set1_ps ( factors_.direction_sin );
+    const __m256 speed_min = _mm256_set1_ps ( factors_.speed_min ), speed_range = _mm256_set1_ps ( factors_.speed_range );
+    const __m256 lifetime_min = _mm256_set1_ps ( factors_.lifetime_min ), lifetime_range = _mm256_set1_ps ( factors_.lifetime_range );
+    for ( std::size_t i = 0; i < n_; i += 8 ) {
+        __m256 sin, cos;
+        sinCosAvx2 ( _mm256_mul_ps ( _mm256_sub_ps ( uniformFloatAvx2 ( rng_.next ( ) ), half ), spread ), sin, cos );
+        const __m256 v = _mm256_add_ps ( speed_min, _mm256_mul_ps ( uniformFloatAvx2 ( rng_.next ( ) ), speed_range ) );
+        _mm256_store_ps ( vx, _mm256_mul_ps ( _mm256_sub_ps ( _mm256_mul_ps ( cos, direction_cos ), _mm256_mul_ps ( sin, direction_sin ) ), v ) );
+        _mm256_store_ps ( vy, _mm256_mul_ps ( _mm256_add_ps ( _mm256_mul_ps ( sin, direction_cos ), _mm256_mul_ps ( cos, direction_sin ) ), v ) );
+        _mm256_store_ps ( lifetime, _mm256_add_ps ( lifetime_min, _mm256_mul_ps ( uniformFloatAvx2 ( rng_.next ( ) ), lifetime_range ) ) );
+        for ( std::size_t j = 0, l = std::min ( n_ - i, std::size_t { 8 } ); j < l; ++j ) {
+            scatterParticle ( particles_, indices_ [ i + j ], vx [ j ], vy [ j ], lifetime [ j ], emitter_, step_ );
+        }
+    }
+}
+
+static void updateParticlesSse2 ( ParticleArrays & particles_, const std::size_t begin_, const std::size_t end_, const ParticleStep & step_, Uint8 * respawn_mask_ ) noexcept {
+    float * const px = particles_.position_x.data ( ), * const py = particles_.position_y.data ( );
+    const float * const vx = particles_.velocity_x.data ( ), * const vy = particles_.velocity_y.data ( );
+    float * const lt = particles_.lifetime.data ( );
+    Uint32 * const color = particles_.color.data ( );
+    const __m128 dt = _mm_set1_ps ( step_.dt ), alpha_scale = _mm_set1_ps ( step_.alpha_scale ), zero = _mm_setzero_ps ( ), opaque = _mm_set1_ps ( 255.0f );
+    const __m128i rgb = _mm_set1_epi32 ( ( int ) step_.rgb );
+    for ( std::size_t i = begin_; i < end_; i += 8 ) {
+        int mask = 0;
+        for ( std::size_t j = 0; j < 8; j += 4 ) {
+            const std::size_t k = i + j;
+            const __m128 l = _mm_sub_ps ( _mm_load_ps ( lt + k ), dt );
+            _mm_store_ps ( lt + k, l );
+            _mm_store_ps ( px + k, _mm_add_ps ( _mm_load_ps ( px + k ), _mm_mul_ps ( _mm_load_ps ( vx + k ), dt ) ) );
+            _mm_store_ps ( py + k, _mm_add_ps ( _mm_load_ps ( py + k ), _mm_mul_ps ( _mm_load_ps ( vy + k ), dt ) ) );
+            const __m128i alpha = _mm_cvttps_epi32 ( _mm_min_ps ( _mm_max_ps ( _mm_mul_ps ( l, alpha_scale ), zero ), opaque ) );
+            _mm_store_si128 ( reinterpret_cast<__m128i *> ( color + k ), _mm_or_si128 ( rgb, _mm_slli_epi32 ( alpha, 24 ) ) );
+            mask |= _mm_movemask_ps ( _mm_cmple_ps ( l, zero ) ) << j;
+        }
+        respawn_mask_ [ i / 8 ] = ( Uint8 ) mask;
+    }
+}
+
+SFML_EXTENSIONS_TARGET_AVX2 static void updateParticlesAvx2 ( ParticleArrays & particles_, const std::size_t begin_, const std::size_t end_, const ParticleStep & step_, Uint8 * respawn_mask_ ) noexcept {
+    float * const px = particles_.position_x.data ( ), * const py = particles_.position_y.data ( );
+    const float * const vx = particles_.velocity_x.data ( ), * const vy = particles_.velocity_y.data ( );
+    float * const lt = particles_.lifetime.data ( );
+    Uint32 * const color = particles_.color.data ( );
+    const __m256 dt = _mm256_set1_ps ( step_.dt ), alpha_scale = _mm256_set1_ps ( step_.alpha_scale ), zero = _mm256_setzero_ps ( ), opaque = _mm256_set1_ps ( 255.0f );
+    const __m256i rgb = _mm256_set1_epi32 ( ( int ) step_.rgb );
+    for ( std::size_t i = begin_; i < end_; i += 8 ) {
+        const __m256 l = _mm256_sub_ps ( _mm256_load_ps ( lt + i ), dt );
+        _mm256_store_ps ( lt + i, l );
+        _mm256_store_ps ( px + i, _mm256_add_ps ( _mm256_load_ps ( px + i ), _mm256_mul_ps ( _mm256_load_ps ( vx + i ), dt ) ) );
+        _mm256_store_ps ( py + i, _mm256_add_ps ( _mm256_load_ps ( py + i ), _mm256_mul_ps ( _mm256_load_ps ( vy + i ), dt ) ) );
+        const __m256i alpha = _mm256_cvttps_epi32 ( _mm256_min_ps ( _mm256_max_ps ( _mm256_mul_ps ( l, alpha_scale ), zero ), opaque ) );
+        _mm256_store_si256 ( reinterpret_cast<__m256i *> ( color + i ), _mm256_or_si256 ( rgb, _mm256_slli_epi32 ( alpha, 24 ) ) );
+        respawn_mask_ [ i / 8 ] = ( Uint8 ) _mm256_movemask_ps ( _mm256_cmp_ps ( l, zero, _CMP_LE_OQ ) );
+    }
+}
+
+#endif
+
+ParticleUpdateKernel particleUpdateKernel ( const SimdLevel level_ ) noexcept {
+    switch ( level_ ) {
+#ifdef SFML_EXTENSIONS_X64
+        case SimdLevel::AVX2: return updateParticlesAvx2;
+        case SimdLevel::SSE2: return updateParticlesSse2;
+#endif
+        default: return updateParticlesScalar;
+    }
+}
+
+ParticleRespawnKernel particleRespawnKernel ( const SimdLevel level_ ) noexcept {
+    // Sse2 falls back to the scalar respawn.
+    switch ( level_ ) {
+#ifdef SFML_EXTENSIONS_X64
+        case SimdLevel::AVX2: return respawnParticlesAvx2;
+#endif
+        default: return respawnParticlesScalar;
+    }
+}
+}
@@ -0,0 +1,58 @@
+
+// MIT License
+//
+// Copyright (c) 2019 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Extensions/ParticleSystem.hpp"
+
+namespace sf::detail {
+
+// Red in the low byte, i.e. the sf::Color memory layout on little-endian.
+inline Uint32 packColor ( const Color color_ ) noexcept {
+    return ( Uint32 ) color_.r | ( Uint32 ) color_.g << 8 | ( Uint32 ) color_.b << 16 | ( Uint32 ) color_.a << 24;
+}
+
+inline Color unpackColor ( const Uint32 color_ ) noexcept {
+    return Color { ( Uint8 ) color_, ( Uint8 ) ( color_ >> 8 ), ( Uint8 ) ( color_ >> 16 ), ( Uint8 ) ( color_ >> 24 ) };
+}
+
+// Integrates position, decrements lifetime and writes color for the particles
+// [ begin_, end_ ), both multiples of ParticleArrays::lanes. Bit j of
+// respawn_mask_ [ i / lanes ] is set if particle i + j died.
+using ParticleUpdateKernel = void ( * ) ( ParticleArrays & particles_, const std::size_t begin_, const std::size_t end_, const ParticleStep & step_, Uint8 * respawn_mask_ ) noexcept;
+
+ParticleUpdateKernel particleUpdateKernel ( const SimdLevel level_ ) noexcept;
+
+// The update kernel over the particles alive_ [ 0, n_ ) instead of a range.
+// The survivors are compacted to the front of alive_ and their number is
+// returned, the particles that died are appended to dead_ [ dead_count_ ].
+std::size_t updateAliveParticles ( ParticleArrays & particles_, Uint32 * alive_, const std::size_t n_, Uint32 * dead_, std::size_t & dead_count_, const ParticleStep & step_ ) noexcept;
+
+// Respawns the particles indices_ [ 0, n_ ) in batches of 8, drawing the
+// random numbers for a batch with 3 steps of rng_: a direction, speed and
+// lifetime as per factors_, the position one step ( step_.dt ) from emitter_,
+// and the color.
+using ParticleRespawnKernel = void ( * ) ( ParticleArrays & particles_, const Uint32 * indices_, const std::size_t n_, ParticleRng & rng_, const EmitterFactors & factors_, const Vector2f emitter_, const ParticleStep & step_ ) noexcept;
+
+ParticleRespawnKernel particleRespawnKernel ( const SimdLevel level_ ) noexcept;
+}
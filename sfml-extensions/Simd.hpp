@@ -0,0 +1,38 @@
+
+// MIT License
+//
+// Copyright (c) 2019 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// Private to the library, the vector kernels are compiled for their target
+// instruction set per function and selected at runtime with cpuSimdLevel ( ).
+
+#if defined ( _M_X64 ) or defined ( __x86_64__ )
+#    define SFML_EXTENSIONS_X64
+#    include <immintrin.h>
+#endif
+
+#if defined ( __clang__ ) or defined ( __GNUC__ )
+#    define SFML_EXTENSIONS_TARGET_AVX2 __attribute__ ( ( target ( "avx2" ) ) )
+#else
+#    define SFML_EXTENSIONS_TARGET_AVX2
+#endif
@@ -0,0 +1,100 @@
+
+// MIT License
+//
+// Copyright (c) 2019 degski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Extensions/ThreadPool.hpp"
+
+namespace sf {
+
+ThreadPool::ThreadPool ( const Uint32 workers_ ) {
+    m_workers.reserve ( workers_ );
+    for ( Uint32 i = 0u; i < workers_; ++i ) {
+        m_workers.emplace_back ( &ThreadPool::work, this );
+    }
+}
+
+ThreadPool::~ThreadPool ( ) {
+    {
+        std::lock_guard<std::mutex> lock ( m_mutex );
+        m_stop = true;
+    }
+    m_wake.notify_all ( );
+    for ( std::thread & worker : m_workers ) {
+        worker.join ( );
+    }
+}
+
+void ThreadPool::run ( const std::size_t count_, Job job_, void * data_ ) {
+    if ( not count_ ) {
+        return;
+    }
+    if ( m_workers.empty ( ) or 1u == count_ ) {
+        for ( std::size_t i = 0; i < count_; ++i ) {
+            job_ ( data_, i );
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock ( m_mutex );
+        m_job = job_;
+        m_data = data_;
+        m_count = count_;
+        m_next.store ( 0, std::memory_order_relaxed );
+        m_busy = ( Uint32 ) m_workers.size ( );
+        ++m_generation;
+    }
+    m_wake.notify_all ( );
+    drain ( );
+    // Every worker has to check in, so none of them is still looking at this
+    // job when the next one is set up.
+    std::unique_lock<std::mutex> lock ( m_mutex );
+    m_done.wait ( lock, [ this ] { return not m_busy; } );
+}
+
+void ThreadPool::work ( ) {
+    Uint64 generation = 0;
+    while ( true ) {
+        {
+            std::unique_lock<std::mutex> lock ( m_mutex );
+            m_wake.wait ( lock, [ this, generation ] { return m_stop or m_generation != generation; } );
+            if ( m_stop ) {
+                return;
+            }
+            generation = m_generation;
+        }
+        drain ( );
+        {
+            std::lock_guard<std::mutex> lock ( m_mutex );
+            if ( not --m_busy ) {
+                m_done.notify_one ( );
+            }
+        }
+    }
+}
+
+void ThreadPool::drain ( ) noexcept {
+    for ( std::size_t i = m_next.fetch_add ( 1, std::memory_order_relaxed ); i < m_count; i = m_next.fetch_add ( 1, std::memory_order_relaxed ) ) {
+        m_job ( m_data, i );
+    }
+}
+
+}
@@ -216,6 +216,93 @@ int main243654765876987 ( ) {
 }
 
 
+// Array-of-structs ParticleSystem vs. structure-of-arrays ParticleSystemSoA,
+// 3 systems of 50'000 particles as above, no window.
+template<typename System>
+double benchmarkParticleUpdate ( const int frames_ ) {
+    System particle_0 ( 50'000 ), particle_1 ( 50'000 ), particle_2 ( 50'000 );
+    const sf::Time elapsed = sf::milliseconds ( 16 );
+    const sf::Color color ( 128, 128, 128 );
+    sf::NanoTimer timer;
+    timer.start ( );
+    for ( int i = 0; i < frames_; ++i ) {
+        particle_0.update ( elapsed, color );
+        particle_1.update ( elapsed, color );
+        particle_2.update ( elapsed, color );
+    }
+    return timer.getElapsedNs ( ) / ( frames_ * 150'000.0 );
+}
+
+int main_particle_storage ( ) {
+
+    constexpr int frames = 1'000;
+
+    benchmarkParticleUpdate<sf::ParticleSystemSoA> ( 10 ); // Warm up.
+
+    std::cout << "AoS " << benchmarkParticleUpdate<sf::ParticleSystem> ( frames ) << " ns/particle" << nl;
+    std::cout << "SoA " << benchmarkParticleUpdate<sf::ParticleSystemSoA> ( frames ) << " ns/particle" << nl;
+
+    return 0;
+}
+
+
+// ParticleSystem::update vs. the ParticleSystemSoA kernels at each simd level.
+template<typename System>
+double benchmarkParticleUpdate ( System & system_, const int frames_, const int count_ ) {
+    const sf::Time elapsed = sf::milliseconds ( 16 );
+    const sf::Color color ( 128, 128, 128 );
+    sf::NanoTimer timer;
+    timer.start ( );
+    for ( int i = 0; i < frames_; ++i ) {
+        system_.update ( elapsed, color );
+    }
+    return timer.getElapsedNs ( ) / ( ( double ) frames_ * count_ );
+}
+
+int main_particle_simd ( ) {
+
+    const char * const names [ ] = { "scalar", "sse2", "avx2" };
+
+    for ( const int count : { 10'000, 100'000, 1'000'000 } ) {
+
+        const int frames = 100'000'000 / count;
+
+        sf::ParticleSystem aos ( count );
+        std::cout << count << " aos  " << benchmarkParticleUpdate ( aos, frames, count ) << " ns/particle" << nl;
+
+        for ( const sf::SimdLevel level : { sf::SimdLevel::Scalar, sf::SimdLevel::SSE2, sf::SimdLevel::AVX2 } ) {
+            if ( level > sf::cpuSimdLevel ( ) ) {
+                break;
+            }
+            sf::ParticleSystemSoA soa ( count );
+            soa.setSimdLevel ( level );
+            std::cout << count << " " << names [ ( int ) level ] << " " << benchmarkParticleUpdate ( soa, frames, count ) << " ns/particle" << nl;
+        }
+    }
+
+    return 0;
+}
+
+
+// Vertex generation throughput of ParticleSystemSoA: points vs. quads, no
+// window, the update includes the integration.
+int main_particle_vertices ( ) {
+
+    constexpr int count = 100'000, frames = 1'000;
+
+    for ( int mode = 0; mode < 3; ++mode ) {
+        sf::ParticleSystemSoA soa ( count );
+        if ( mode )
+            soa.setQuads ( { 4.0f, 4.0f }, { 0.0f, 0.0f, 16.0f, 16.0f }, 2 == mode );
+        const double ns = benchmarkParticleUpdate ( soa, frames, count );
+        const char * const names [ ] = { "points ", "quads  ", "rotated" };
+        std::cout << names [ mode ] << " " << ns << " ns/particle, " << ( mode ? 4'000.0 : 1'000.0 ) / ns << " Mvertices/s" << nl;
+    }
+
+    return 0;
+}
+
+
 LARGE_INTEGER g_frequency;
 const double kDelayTime = 1.0;
 